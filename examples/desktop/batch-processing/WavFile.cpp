@@ -0,0 +1,323 @@
+#include "WavFile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+constexpr size_t HEADER_SIZE = 44;
+
+size_t getPageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t) info.dwPageSize;
+#else
+    return (size_t) sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// WAV files are little endian, reading byte by byte also handles unaligned fields
+template <typename T>
+T readLittleEndian(const uint8_t* data) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= (T) data[i] << (8 * i);
+    }
+    return value;
+}
+
+void writeLittleEndian(uint8_t* data, uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        data[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::openForReading(const std::string& path) {
+    close();
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::runtime_error("Could not open " + path);
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(m_file, &size);
+    m_size = (size_t) size.QuadPart;
+    if (m_size > 0) {
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        m_data = m_mapping != nullptr ? (uint8_t*) MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    }
+#else
+    m_file = ::open(path.c_str(), O_RDONLY);
+    if (m_file < 0) {
+        throw std::runtime_error("Could not open " + path);
+    }
+    struct stat file_stat;
+    fstat(m_file, &file_stat);
+    m_size = (size_t) file_stat.st_size;
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+        m_data = data != MAP_FAILED ? (uint8_t*) data : nullptr;
+    }
+    if (m_data != nullptr) {
+        madvise(m_data, m_size, MADV_SEQUENTIAL);
+    }
+#endif
+    if (m_data == nullptr) {
+        close();
+        throw std::runtime_error("Could not map " + path);
+    }
+    m_writable = false;
+}
+
+void MappedFile::openForWriting(const std::string& path, size_t size) {
+    close();
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::runtime_error("Could not create " + path);
+    }
+    // Mapping with the full size grows the file
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, (DWORD) ((uint64_t) size >> 32), (DWORD) size, nullptr);
+    m_data = m_mapping != nullptr ? (uint8_t*) MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, 0) : nullptr;
+#else
+    m_file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_file < 0) {
+        throw std::runtime_error("Could not create " + path);
+    }
+    if (ftruncate(m_file, (off_t) size) == 0) {
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+        m_data = data != MAP_FAILED ? (uint8_t*) data : nullptr;
+    }
+#endif
+    if (m_data == nullptr) {
+        close();
+        throw std::runtime_error("Could not map " + path);
+    }
+    m_size = size;
+    m_writable = true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (m_data != nullptr) {
+        if (m_writable) {
+            FlushViewOfFile(m_data, 0);
+        }
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data != nullptr) {
+        munmap(m_data, m_size);
+    }
+    if (m_file >= 0) {
+        ::close(m_file);
+    }
+    m_file = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void MappedFile::release(size_t offset, size_t size) {
+    // Only whole pages inside the range can be released
+    size_t page_size = getPageSize();
+    size_t begin = (offset + page_size - 1) / page_size * page_size;
+    size_t end = (offset + size) / page_size * page_size;
+    if (m_data == nullptr || end <= begin) {
+        return;
+    }
+#ifdef _WIN32
+    if (m_writable) {
+        FlushViewOfFile(m_data + begin, end - begin);
+    }
+    // Unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(m_data + begin, end - begin);
+#else
+    if (m_writable) {
+        msync(m_data + begin, end - begin, MS_SYNC);
+    }
+    madvise(m_data + begin, end - begin, MADV_DONTNEED);
+#endif
+}
+
+void WavReader::open(const std::string& path) {
+    m_file.openForReading(path);
+    const uint8_t* data = m_file.getData();
+    size_t size = m_file.getSize();
+
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        throw std::runtime_error(path + " is not a WAV file");
+    }
+
+    uint16_t format = 0;
+    size_t bits_per_sample = 0;
+    size_t data_size = 0;
+    size_t offset = 12;
+    bool found_format = false;
+    bool found_data = false;
+    while (offset + 8 <= size && !found_data) {
+        const uint8_t* chunk = data + offset;
+        size_t chunk_size = readLittleEndian<uint32_t>(chunk + 4);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && offset + 8 + 16 <= size) {
+            format = readLittleEndian<uint16_t>(chunk + 8);
+            m_num_channels = readLittleEndian<uint16_t>(chunk + 10);
+            m_sample_rate = (double) readLittleEndian<uint32_t>(chunk + 12);
+            bits_per_sample = readLittleEndian<uint16_t>(chunk + 22);
+            // The sub format starts with the format tag of the actual encoding
+            if (format == WAVE_FORMAT_EXTENSIBLE && chunk_size >= 40 && offset + 8 + 26 <= size) {
+                format = readLittleEndian<uint16_t>(chunk + 32);
+            }
+            found_format = true;
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0) {
+            m_data_offset = offset + 8;
+            // Streaming writers leave the size at 0 or 0xFFFFFFFF, the data then runs to the end of the file
+            data_size = chunk_size;
+            if (data_size == 0 || m_data_offset + data_size > size) {
+                data_size = size - m_data_offset;
+            }
+            found_data = true;
+        }
+        // Chunks are padded to an even size
+        offset += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    if (!found_format || !found_data) {
+        throw std::runtime_error(path + " has no fmt or data chunk");
+    }
+    if (m_num_channels == 0 || m_sample_rate <= 0.) {
+        throw std::runtime_error(path + " has an invalid format");
+    }
+    if (format == WAVE_FORMAT_PCM && (bits_per_sample == 16 || bits_per_sample == 24 || bits_per_sample == 32)) {
+        m_is_float = false;
+    }
+    else if (format == WAVE_FORMAT_IEEE_FLOAT && bits_per_sample == 32) {
+        m_is_float = true;
+    }
+    else {
+        throw std::runtime_error(path + " uses an unsupported sample format (" + std::to_string(format) + ", " + std::to_string(bits_per_sample) + " bit)");
+    }
+
+    m_bytes_per_sample = bits_per_sample / 8;
+    m_num_frames = data_size / (m_bytes_per_sample * m_num_channels);
+    m_samples = data + m_data_offset;
+    m_released = 0;
+}
+
+void WavReader::read(float* const* output, size_t startFrame, size_t numFrames) const {
+    const size_t frame_size = m_bytes_per_sample * m_num_channels;
+    const uint8_t* frame = m_samples + startFrame * frame_size;
+    for (size_t i = 0; i < numFrames; ++i, frame += frame_size) {
+        for (size_t channel = 0; channel < m_num_channels; ++channel) {
+            const uint8_t* sample = frame + channel * m_bytes_per_sample;
+            float value;
+            if (m_is_float) {
+                std::memcpy(&value, sample, sizeof(float));
+            }
+            else if (m_bytes_per_sample == 2) {
+                value = (float) (int16_t) readLittleEndian<uint16_t>(sample) / 32768.f;
+            }
+            else if (m_bytes_per_sample == 3) {
+                // Shift the 24 bits into the upper bytes so the sign is extended
+                uint32_t bits = (uint32_t) sample[0] << 8 | (uint32_t) sample[1] << 16 | (uint32_t) sample[2] << 24;
+                value = (float) ((int32_t) bits >> 8) / 8388608.f;
+            }
+            else {
+                value = (float) ((double) (int32_t) readLittleEndian<uint32_t>(sample) / 2147483648.);
+            }
+            output[channel][i] = value;
+        }
+    }
+}
+
+void WavReader::release(size_t endFrame) {
+    size_t end = m_data_offset + endFrame * m_bytes_per_sample * m_num_channels;
+    if (end > m_released) {
+        m_file.release(m_released, end - m_released);
+        m_released = end;
+    }
+}
+
+void WavWriter::open(const std::string& path, size_t numChannels, size_t numFrames, double sampleRate) {
+    m_num_channels = numChannels;
+    m_num_frames = numFrames;
+    m_data_offset = HEADER_SIZE;
+    m_released = 0;
+
+    size_t data_size = numFrames * numChannels * sizeof(float);
+    if (data_size > UINT32_MAX - HEADER_SIZE) {
+        throw std::runtime_error(path + " would exceed the 4 GB limit of WAV files");
+    }
+    m_file.openForWriting(path, HEADER_SIZE + data_size);
+
+    uint8_t* header = m_file.getData();
+    std::memcpy(header, "RIFF", 4);
+    writeLittleEndian(header + 4, (uint32_t) (HEADER_SIZE - 8 + data_size), 4);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    writeLittleEndian(header + 16, 16, 4);
+    writeLittleEndian(header + 20, WAVE_FORMAT_IEEE_FLOAT, 2);
+    writeLittleEndian(header + 22, (uint32_t) numChannels, 2);
+    writeLittleEndian(header + 24, (uint32_t) sampleRate, 4);
+    writeLittleEndian(header + 28, (uint32_t) (sampleRate * (double) (numChannels * sizeof(float))), 4);
+    writeLittleEndian(header + 32, (uint32_t) (numChannels * sizeof(float)), 2);
+    writeLittleEndian(header + 34, 32, 2);
+    std::memcpy(header + 36, "data", 4);
+    writeLittleEndian(header + 40, (uint32_t) data_size, 4);
+
+    // The header is 44 bytes long, so the samples are aligned to 4 bytes
+    m_samples = (float*) (m_file.getData() + m_data_offset);
+}
+
+void WavWriter::close() {
+    m_file.close();
+    m_samples = nullptr;
+}
+
+void WavWriter::write(const float* const* input, size_t startFrame, size_t numFrames) {
+    float* frame = m_samples + startFrame * m_num_channels;
+    for (size_t i = 0; i < numFrames; ++i, frame += m_num_channels) {
+        for (size_t channel = 0; channel < m_num_channels; ++channel) {
+            frame[channel] = input[channel][i];
+        }
+    }
+}
+
+void WavWriter::release(size_t endFrame) {
+    size_t end = m_data_offset + endFrame * m_num_channels * sizeof(float);
+    if (end > m_released) {
+        m_file.release(m_released, end - m_released);
+        m_released = end;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef ANIRA_BATCH_PROCESSING_WAVFILE_H
+#define ANIRA_BATCH_PROCESSING_WAVFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only or read-write memory mapping of a whole file. Pages are only loaded when they are touched, release() hands processed ranges back to the OS so the resident memory stays at about one chunk per open file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Throws std::runtime_error if the file can not be opened or mapped
+    void openForReading(const std::string& path);
+    // Creates or truncates the file to the given size
+    void openForWriting(const std::string& path, size_t size);
+    void close();
+
+    uint8_t* getData() const { return m_data; }
+    size_t getSize() const { return m_size; }
+
+    // Writes back the dirty pages in [offset, offset + size) and drops all pages of the range from the resident set
+    void release(size_t offset, size_t size);
+
+private:
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_writable = false;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+};
+
+// Supports 16, 24 and 32 bit integer PCM and 32 bit float, also in WAVE_FORMAT_EXTENSIBLE files
+class WavReader {
+public:
+    void open(const std::string& path);
+
+    size_t getNumChannels() const { return m_num_channels; }
+    size_t getNumFrames() const { return m_num_frames; }
+    double getSampleRate() const { return m_sample_rate; }
+
+    // Deinterleaves and converts numFrames frames starting at startFrame into output[channel][0, numFrames)
+    void read(float* const* output, size_t startFrame, size_t numFrames) const;
+    // Drops the frames before endFrame from the resident memory
+    void release(size_t endFrame);
+
+private:
+    MappedFile m_file;
+    const uint8_t* m_samples = nullptr;
+    size_t m_data_offset = 0;
+    size_t m_num_channels = 0;
+    size_t m_num_frames = 0;
+    size_t m_bytes_per_sample = 0;
+    bool m_is_float = false;
+    double m_sample_rate = 0.;
+    size_t m_released = 0;
+};
+
+// Writes 32 bit float files, the length must be known in advance
+class WavWriter {
+public:
+    void open(const std::string& path, size_t numChannels, size_t numFrames, double sampleRate);
+    void close();
+
+    // Interleaves input[channel][0, numFrames) into the frames starting at startFrame
+    void write(const float* const* input, size_t startFrame, size_t numFrames);
+    // Flushes the frames before endFrame to disk and drops them from the resident memory
+    void release(size_t endFrame);
+
+private:
+    MappedFile m_file;
+    float* m_samples = nullptr;
+    size_t m_data_offset = 0;
+    size_t m_num_channels = 0;
+    size_t m_num_frames = 0;
+    size_t m_released = 0;
+};
+
+#endif //ANIRA_BATCH_PROCESSING_WAVFILE_H
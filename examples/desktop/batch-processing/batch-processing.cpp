@@ -0,0 +1,390 @@
+/* ==========================================================================
+
+Batch processing of WAV files with anira in offline mode. The files are
+streamed in chunks through memory mappings and several files are processed
+in parallel, each worker owns one multichannel InferenceHandler and all of
+them share the inference thread pool.
+
+Reports the real-time factor (processing time / audio duration) of every
+file and of the whole batch together with the peak resident set size.
+
+========================================================================== */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include <anira/anira.h>
+
+#include "../../../extras/desktop/models/cnn/CNNConfig.h"
+#include "../../../extras/desktop/models/cnn/CNNPrePostProcessor.h"
+#include "../../../extras/desktop/models/hybrid-nn/HybridNNConfig.h"
+#include "../../../extras/desktop/models/hybrid-nn/HybridNNPrePostProcessor.h"
+#include "../../../extras/desktop/models/stateful-rnn/StatefulRNNConfig.h"
+#include "../../../extras/desktop/models/stateful-rnn/StatefulRNNPrePostProcessor.h"
+
+#include "WavFile.h"
+
+struct Options {
+    std::string model = "cnn";
+    anira::InferenceBackend backend = (anira::InferenceBackend) 0;
+    size_t bufferSize = 2048;
+    // Processed frames after which the pages of the input and output file are released
+    size_t chunkSize = 1 << 16;
+    int numJobs = 0;
+    int numInferenceThreads = 0;
+    std::filesystem::path outputDirectory;
+    std::vector<std::filesystem::path> inputs;
+};
+
+struct FileResult {
+    std::filesystem::path input;
+    std::filesystem::path output;
+    size_t numChannels = 0;
+    size_t numFrames = 0;
+    double sampleRate = 0.;
+    double prepareTime = 0.; // seconds
+    double processTime = 0.; // seconds
+    std::string error;
+
+    double getDuration() const {
+        return sampleRate > 0. ? (double) numFrames / sampleRate : 0.;
+    }
+};
+
+static size_t getPeakResidentSetSize() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return (size_t) counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return (size_t) usage.ru_maxrss;
+#else
+    return (size_t) usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+static double getSecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Creating, preparing and destroying sessions reconfigures the shared inference thread pool, so the workers must not do it concurrently
+static std::mutex sessionMutex;
+
+// The handler is prepared again for every file with its channel count, which also resets the model state. The channels run as parallel inferences unless the config batches them.
+template <typename PrePostProcessorType>
+class FileProcessor {
+public:
+    FileProcessor(const Options& options, const anira::InferenceConfig& config) : m_options(options), m_config(config) {
+    }
+
+    ~FileProcessor() {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        m_handler.reset();
+    }
+
+    FileResult process(const std::filesystem::path& input, const std::filesystem::path& output) {
+        FileResult result;
+        result.input = input;
+        result.output = output;
+
+        auto start = std::chrono::steady_clock::now();
+
+        WavReader reader;
+        reader.open(input.string());
+        result.numChannels = reader.getNumChannels();
+        result.numFrames = reader.getNumFrames();
+        result.sampleRate = reader.getSampleRate();
+
+        WavWriter writer;
+        writer.open(output.string(), reader.getNumChannels(), reader.getNumFrames(), reader.getSampleRate());
+
+        prepare(reader.getNumChannels(), reader.getSampleRate());
+        result.prepareTime = getSecondsSince(start);
+        start = std::chrono::steady_clock::now();
+
+        const size_t num_channels = reader.getNumChannels();
+        const size_t num_frames = reader.getNumFrames();
+        const size_t buffer_size = m_options.bufferSize;
+        // In offline mode the output of a block is complete when process returns, the latency only holds the buffer adaptation and the model latency and is cut from the start of the file
+        size_t latency = (size_t) m_handler->getLatency();
+
+        size_t read = 0;
+        size_t written = 0;
+        size_t next_release = m_options.chunkSize;
+        while (written < num_frames) {
+            size_t num_read = std::min(buffer_size, num_frames - read);
+            reader.read(m_buffer_pointers.data(), read, num_read);
+            read += num_read;
+            // After the end of the file the handler is fed with silence until the delayed output is flushed
+            for (size_t channel = 0; channel < num_channels; ++channel) {
+                std::fill(m_buffer_pointers[channel] + num_read, m_buffer_pointers[channel] + buffer_size, 0.f);
+            }
+            m_handler->process(m_buffer_pointers.data(), buffer_size);
+
+            size_t num_skipped = std::min(latency, buffer_size);
+            latency -= num_skipped;
+            size_t num_written = std::min(buffer_size - num_skipped, num_frames - written);
+            for (size_t channel = 0; channel < num_channels; ++channel) {
+                m_write_pointers[channel] = m_buffer_pointers[channel] + num_skipped;
+            }
+            writer.write(m_write_pointers.data(), written, num_written);
+            written += num_written;
+
+            if (written >= next_release) {
+                reader.release(read);
+                writer.release(written);
+                next_release = written + m_options.chunkSize;
+            }
+        }
+        writer.close();
+
+        result.processTime = getSecondsSince(start);
+        return result;
+    }
+
+private:
+    void prepare(size_t numChannels, double sampleRate) {
+        anira::HostAudioConfig host_config = {numChannels, m_options.bufferSize, sampleRate};
+        std::lock_guard<std::mutex> lock(sessionMutex);
+
+        if (m_handler == nullptr) {
+            m_handler = std::make_unique<anira::InferenceHandler>(m_pre_post_processor, m_config);
+            m_handler->setOfflineMode(true);
+            m_handler->setInferenceBackend(m_options.backend);
+        }
+        m_handler->prepare(host_config);
+
+        while (m_buffers.size() < numChannels) {
+            m_buffers.emplace_back(m_options.bufferSize);
+        }
+
+        m_buffer_pointers.resize(m_buffers.size());
+        m_write_pointers.resize(m_buffers.size());
+        for (size_t channel = 0; channel < m_buffers.size(); ++channel) {
+            m_buffer_pointers[channel] = m_buffers[channel].data();
+        }
+    }
+
+    const Options& m_options;
+    anira::InferenceConfig m_config;
+
+    PrePostProcessorType m_pre_post_processor;
+    std::unique_ptr<anira::InferenceHandler> m_handler;
+    std::vector<std::vector<float>> m_buffers;
+    std::vector<float*> m_buffer_pointers;
+    std::vector<const float*> m_write_pointers;
+};
+
+template <typename PrePostProcessorType>
+std::vector<FileResult> processFiles(const Options& options, anira::InferenceConfig config) {
+    if (options.numInferenceThreads > 0) {
+        config.m_number_of_threads = options.numInferenceThreads;
+    }
+
+    std::vector<FileResult> results(options.inputs.size());
+    std::atomic<size_t> next_file {0};
+
+    auto worker = [&] () {
+        FileProcessor<PrePostProcessorType> processor(options, config);
+        for (size_t i = next_file.fetch_add(1); i < options.inputs.size(); i = next_file.fetch_add(1)) {
+            const std::filesystem::path& input = options.inputs[i];
+            std::filesystem::path output = options.outputDirectory.empty() ? input.parent_path() / (input.stem().string() + "-processed.wav") : options.outputDirectory / (input.stem().string() + ".wav");
+            try {
+                results[i] = processor.process(input, output);
+            }
+            catch (const std::exception& e) {
+                results[i].input = input;
+                results[i].output = output;
+                results[i].error = e.what();
+            }
+            std::cout << "[" << (results[i].error.empty() ? "done" : "failed") << "] " << input.string() << std::endl;
+        }
+    };
+
+    int num_jobs = options.numJobs > 0 ? options.numJobs : config.m_number_of_threads;
+    num_jobs = std::max(std::min(num_jobs, (int) options.inputs.size()), 1);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < num_jobs; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    return results;
+}
+
+static void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options] <input.wav>..." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -m, --model <name>          cnn, hybrid-nn or stateful-rnn (default cnn)" << std::endl;
+    std::cout << "  -b, --backend <name>        backend to run the model on:";
+    for (int i = 0; i <= anira::NONE; ++i) {
+        std::cout << " " << anira::getInferenceBackendName((anira::InferenceBackend) i);
+    }
+    std::cout << " (default " << anira::getInferenceBackendName((anira::InferenceBackend) 0) << ")" << std::endl;
+    std::cout << "  -o, --output-dir <path>     directory for the processed files (default: next to the input with the suffix -processed)" << std::endl;
+    std::cout << "  -j, --jobs <n>              files processed in parallel (default: number of inference threads)" << std::endl;
+    std::cout << "  -t, --threads <n>           inference threads (default: from the model config)" << std::endl;
+    std::cout << "      --buffer-size <n>       samples per process call (default 2048)" << std::endl;
+    std::cout << "      --chunk-size <n>        frames between releases of the mapped file pages (default 65536)" << std::endl;
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&] () -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            return false;
+        }
+        else if (arg == "-m" || arg == "--model") {
+            options.model = value();
+        }
+        else if (arg == "-b" || arg == "--backend") {
+            std::string name = value();
+            int backend = 0;
+            while (backend <= anira::NONE && name != anira::getInferenceBackendName((anira::InferenceBackend) backend)) {
+                ++backend;
+            }
+            if (backend > anira::NONE) {
+                throw std::runtime_error("Backend " + name + " is not available in this build");
+            }
+            options.backend = (anira::InferenceBackend) backend;
+        }
+        else if (arg == "-o" || arg == "--output-dir") {
+            options.outputDirectory = value();
+        }
+        else if (arg == "-j" || arg == "--jobs") {
+            options.numJobs = std::stoi(value());
+        }
+        else if (arg == "-t" || arg == "--threads") {
+            options.numInferenceThreads = std::stoi(value());
+        }
+        else if (arg == "--buffer-size") {
+            options.bufferSize = (size_t) std::stoul(value());
+        }
+        else if (arg == "--chunk-size") {
+            options.chunkSize = (size_t) std::stoul(value());
+        }
+        else if (!arg.empty() && arg[0] == '-') {
+            throw std::runtime_error("Unknown option " + arg);
+        }
+        else {
+            options.inputs.emplace_back(arg);
+        }
+    }
+    if (options.bufferSize == 0 || options.chunkSize == 0) {
+        throw std::runtime_error("The buffer and chunk size must be greater than 0");
+    }
+    return !options.inputs.empty();
+}
+
+static void printReport(const std::vector<FileResult>& results, double wallTime) {
+    double total_duration = 0.;
+    double total_process_time = 0.;
+    size_t num_failed = 0;
+
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(40) << "file" << std::right << std::setw(4) << "ch" << std::setw(12) << "audio [s]" << std::setw(14) << "prepare [ms]" << std::setw(14) << "process [s]" << std::setw(10) << "RTF" << std::endl;
+    for (const FileResult& result : results) {
+        std::string name = result.input.filename().string();
+        if (name.size() > 39) {
+            name = name.substr(0, 36) + "...";
+        }
+        std::cout << std::left << std::setw(40) << name << std::right;
+        if (!result.error.empty()) {
+            std::cout << "  error: " << result.error << std::endl;
+            ++num_failed;
+            continue;
+        }
+        double duration = result.getDuration();
+        total_duration += duration;
+        total_process_time += result.processTime;
+        std::cout << std::setw(4) << result.numChannels << std::fixed << std::setprecision(2) << std::setw(12) << duration << std::setw(14) << result.prepareTime * 1e3 << std::setw(14) << std::setprecision(3) << result.processTime << std::setw(10) << std::setprecision(4) << (duration > 0. ? result.processTime / duration : 0.) << std::endl;
+    }
+    std::cout << std::defaultfloat << std::endl;
+
+    std::cout << "Files:              " << results.size() - num_failed << " processed, " << num_failed << " failed" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Audio:              " << total_duration << " s" << std::endl;
+    std::cout << "Wall time:          " << wallTime << " s" << std::endl;
+    // The files overlap in time, so the RTF of the batch is based on the wall time and the sum of the per file RTFs would overstate it
+    std::cout << "Real-time factor:   " << std::setprecision(4) << (total_duration > 0. ? wallTime / total_duration : 0.) << " (" << std::setprecision(1) << (wallTime > 0. ? total_duration / wallTime : 0.) << "x real time)" << std::endl;
+    std::cout << "Sum of file times:  " << std::setprecision(3) << total_process_time << " s" << std::endl;
+    std::cout << "Peak RSS:           " << std::setprecision(1) << (double) getPeakResidentSetSize() / (1024. * 1024.) << " MB" << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!options.outputDirectory.empty()) {
+            std::filesystem::create_directories(options.outputDirectory);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "Processing " << options.inputs.size() << " file(s) with the " << options.model << " model on " << anira::getInferenceBackendName(options.backend) << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<FileResult> results;
+    if (options.model == "cnn") {
+        results = processFiles<CNNPrePostProcessor>(options, cnnConfig);
+    }
+    else if (options.model == "hybrid-nn") {
+        results = processFiles<HybridNNPrePostProcessor>(options, hybridNNConfig);
+    }
+    else if (options.model == "stateful-rnn") {
+        results = processFiles<StatefulRNNPrePostProcessor>(options, statefulRNNConfig);
+    }
+    else {
+        std::cerr << "Unknown model " << options.model << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    double wall_time = getSecondsSince(start);
+
+    printReport(results, wall_time);
+
+    bool failed = std::any_of(results.begin(), results.end(), [] (const FileResult& result) { return !result.error.empty(); });
+    return failed ? 1 : 0;
+}
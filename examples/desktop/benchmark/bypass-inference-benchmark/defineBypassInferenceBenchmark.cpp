@@ -82,6 +82,101 @@ BENCHMARK_DEFINE_F(ProcessBlockFixture, BM_ADVANCED)(::benchmark::State& state)
     delete myPrePostProcessor;
 }
 
+// Same as above, but every iteration sends a random block size up to the prepared buffer size
+BENCHMARK_DEFINE_F(ProcessBlockFixture, BM_VARIABLE_BLOCK_SIZE)(::benchmark::State& state) {
+
+    anira::HostAudioConfig hostAudioConfig = {1, (size_t) getBufferSize(), SAMPLE_RATE};
+    hostAudioConfig.variableBufferSize = true;
+    anira::InferenceBackend inferenceBackend = anira::NONE;
+
+    anira::PrePostProcessor *myPrePostProcessor;
+    if (state.range(1) == 0) {
+        myPrePostProcessor = new CNNPrePostProcessor();
+    } else if (state.range(1) == 1) {
+        myPrePostProcessor = new HybridNNPrePostProcessor();
+    } else if (state.range(1) == 2) {
+        myPrePostProcessor = new StatefulRNNPrePostProcessor();
+    }
+
+    m_inferenceHandler = std::make_unique<anira::InferenceHandler>(*myPrePostProcessor, inferenceConfigs[state.range(1)]);
+    m_inferenceHandler->prepare(hostAudioConfig);
+    m_inferenceHandler->setInferenceBackend(inferenceBackend);
+
+    m_buffer = std::make_unique<anira::AudioBuffer<float>>(hostAudioConfig.hostChannels, hostAudioConfig.hostBufferSize);
+
+    initializeRepetition(inferenceConfigs[state.range(1)], hostAudioConfig, inferenceBackend);
+
+    for (auto _ : state) {
+        pushRandomSamplesInBuffer(hostAudioConfig);
+        int blockSize = getRandomBufferSize();
+
+        initializeIteration();
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        m_inferenceHandler->process(m_buffer->getArrayOfWritePointers(), blockSize);
+
+        while (!bufferHasBeenProcessed()) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds (10));
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+        interationStep(start, end, state);
+    }
+    repetitionStep();
+
+    delete myPrePostProcessor;
+}
+
+// Same as BM_ADVANCED, but process() waits up to half a buffer for the inferences, which lowers the reported latency
+BENCHMARK_DEFINE_F(ProcessBlockFixture, BM_WAIT_IN_PROCESS_BLOCK)(::benchmark::State& state) {
+
+    anira::HostAudioConfig hostAudioConfig = {1, (size_t) getBufferSize(), SAMPLE_RATE};
+    anira::InferenceBackend inferenceBackend = anira::NONE;
+    anira::InferenceConfig inferenceConfig = inferenceConfigs[state.range(1)];
+    inferenceConfig.m_wait_in_process_block = 0.5f;
+
+    anira::PrePostProcessor *myPrePostProcessor;
+    if (state.range(1) == 0) {
+        myPrePostProcessor = new CNNPrePostProcessor();
+    } else if (state.range(1) == 1) {
+        myPrePostProcessor = new HybridNNPrePostProcessor();
+    } else if (state.range(1) == 2) {
+        myPrePostProcessor = new StatefulRNNPrePostProcessor();
+    }
+
+    m_inferenceHandler = std::make_unique<anira::InferenceHandler>(*myPrePostProcessor, inferenceConfig);
+    m_inferenceHandler->prepare(hostAudioConfig);
+    m_inferenceHandler->setInferenceBackend(inferenceBackend);
+
+    m_buffer = std::make_unique<anira::AudioBuffer<float>>(hostAudioConfig.hostChannels, hostAudioConfig.hostBufferSize);
+
+    initializeRepetition(inferenceConfig, hostAudioConfig, inferenceBackend);
+
+    for (auto _ : state) {
+        pushRandomSamplesInBuffer(hostAudioConfig);
+
+        initializeIteration();
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        m_inferenceHandler->process(m_buffer->getArrayOfWritePointers(), getBufferSize());
+
+        while (!bufferHasBeenProcessed()) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds (10));
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+        interationStep(start, end, state);
+    }
+    state.counters["latency"] = m_inferenceHandler->getLatency();
+    repetitionStep();
+
+    delete myPrePostProcessor;
+}
+
 // /* ============================================================ *
 //  * ================== BENCHMARK REGISTRATION ================== *
 //  * ============================================================ */
@@ -96,4 +191,28 @@ BENCHMARK_REGISTER_F(ProcessBlockFixture, BM_ADVANCED)
     return anira::benchmark::calculatePercentile(v, PERCENTILE);
   })
 ->DisplayAggregatesOnly(false)
+->UseManualTime();
+
+BENCHMARK_REGISTER_F(ProcessBlockFixture, BM_VARIABLE_BLOCK_SIZE)
+->Unit(benchmark::kMillisecond)
+->Iterations(NUM_ITERATIONS)->Repetitions(NUM_REPETITIONS)
+->Apply(Arguments)
+->ComputeStatistics("min", anira::benchmark::calculateMin)
+->ComputeStatistics("max", anira::benchmark::calculateMax)
+->ComputeStatistics("percentile", [](const std::vector<double>& v) -> double {
+    return anira::benchmark::calculatePercentile(v, PERCENTILE);
+  })
+->DisplayAggregatesOnly(false)
+->UseManualTime();
+
+BENCHMARK_REGISTER_F(ProcessBlockFixture, BM_WAIT_IN_PROCESS_BLOCK)
+->Unit(benchmark::kMillisecond)
+->Iterations(NUM_ITERATIONS)->Repetitions(NUM_REPETITIONS)
+->Apply(Arguments)
+->ComputeStatistics("min", anira::benchmark::calculateMin)
+->ComputeStatistics("max", anira::benchmark::calculateMax)
+->ComputeStatistics("percentile", [](const std::vector<double>& v) -> double {
+    return anira::benchmark::calculatePercentile(v, PERCENTILE);
+  })
+->DisplayAggregatesOnly(false)
 ->UseManualTime();
\ No newline at end of file
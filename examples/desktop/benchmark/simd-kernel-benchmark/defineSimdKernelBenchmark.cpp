@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+#include <anira/anira.h>
+
+#include <random>
+#include <vector>
+
+/* ============================================================ *
+ * ========================= Configs ========================== *
+ * ============================================================ */
+
+#define NUM_REPETITIONS 10
+#define NUM_CHANNELS 2
+
+/* ============================================================ *
+ * ================== BENCHMARK DEFINITIONS =================== *
+ * ============================================================ */
+
+// Every benchmark takes the instruction set as state.range(0) and the number of samples as state.range(1), so that the vectorized kernels can be compared against the scalar ones for each buffer size
+
+const anira::simd::KernelTable* getKernelsOrSkip(benchmark::State& state) {
+    auto instructionSet = static_cast<anira::simd::InstructionSet>(state.range(0));
+    const anira::simd::KernelTable* kernels = anira::simd::getKernels(instructionSet);
+    if (kernels == nullptr) {
+        state.SkipWithError("Instruction set not available on this machine");
+    } else {
+        state.SetLabel(anira::simd::getInstructionSetName(instructionSet));
+    }
+    return kernels;
+}
+
+std::vector<float> createRandomSamples(size_t numSamples) {
+    std::vector<float> samples(numSamples);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    for (auto& sample : samples) {
+        sample = distribution(generator);
+    }
+    return samples;
+}
+
+static void BM_COPY(benchmark::State& state) {
+    const anira::simd::KernelTable* kernels = getKernelsOrSkip(state);
+    if (kernels == nullptr) return;
+
+    size_t numSamples = (size_t) state.range(1);
+    std::vector<float> input = createRandomSamples(numSamples);
+    std::vector<float> output(numSamples);
+
+    for (auto _ : state) {
+        kernels->copy(output.data(), input.data(), numSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * numSamples * sizeof(float)));
+}
+
+static void BM_ADD_WITH_GAIN(benchmark::State& state) {
+    const anira::simd::KernelTable* kernels = getKernelsOrSkip(state);
+    if (kernels == nullptr) return;
+
+    size_t numSamples = (size_t) state.range(1);
+    std::vector<float> input = createRandomSamples(numSamples);
+    std::vector<float> output(numSamples);
+
+    for (auto _ : state) {
+        kernels->addWithGain(output.data(), input.data(), 0.5f, numSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * numSamples * sizeof(float)));
+}
+
+static void BM_INTERLEAVE(benchmark::State& state) {
+    const anira::simd::KernelTable* kernels = getKernelsOrSkip(state);
+    if (kernels == nullptr) return;
+
+    size_t numSamples = (size_t) state.range(1);
+    anira::AudioBufferF input(NUM_CHANNELS, numSamples);
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel) {
+        std::vector<float> samples = createRandomSamples(numSamples);
+        kernels->copy(input.getWritePointer(channel), samples.data(), numSamples);
+    }
+    std::vector<float> output(NUM_CHANNELS * numSamples);
+
+    for (auto _ : state) {
+        kernels->interleave(output.data(), input.getArrayOfReadPointers(), NUM_CHANNELS, numSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * NUM_CHANNELS * numSamples * sizeof(float)));
+}
+
+static void BM_DEINTERLEAVE(benchmark::State& state) {
+    const anira::simd::KernelTable* kernels = getKernelsOrSkip(state);
+    if (kernels == nullptr) return;
+
+    size_t numSamples = (size_t) state.range(1);
+    std::vector<float> input = createRandomSamples(NUM_CHANNELS * numSamples);
+    anira::AudioBufferF output(NUM_CHANNELS, numSamples);
+
+    for (auto _ : state) {
+        kernels->deinterleave(output.getArrayOfWritePointers(), input.data(), NUM_CHANNELS, numSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * NUM_CHANNELS * numSamples * sizeof(float)));
+}
+
+static void BM_FLOAT_TO_INT16(benchmark::State& state) {
+    const anira::simd::KernelTable* kernels = getKernelsOrSkip(state);
+    if (kernels == nullptr) return;
+
+    size_t numSamples = (size_t) state.range(1);
+    std::vector<float> input = createRandomSamples(numSamples);
+    std::vector<int16_t> output(numSamples);
+
+    for (auto _ : state) {
+        kernels->floatToInt16(output.data(), input.data(), numSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * numSamples * sizeof(float)));
+}
+
+static void BM_INT16_TO_FLOAT(benchmark::State& state) {
+    const anira::simd::KernelTable* kernels = getKernelsOrSkip(state);
+    if (kernels == nullptr) return;
+
+    size_t numSamples = (size_t) state.range(1);
+    std::vector<int16_t> input(numSamples);
+    std::vector<float> samples = createRandomSamples(numSamples);
+    kernels->floatToInt16(input.data(), samples.data(), numSamples);
+    std::vector<float> output(numSamples);
+
+    for (auto _ : state) {
+        kernels->int16ToFloat(output.data(), input.data(), numSamples);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t) (state.iterations() * numSamples * sizeof(float)));
+}
+
+// /* ============================================================ *
+//  * ================== BENCHMARK REGISTRATION ================== *
+//  * ============================================================ */
+
+static void kernelArguments(benchmark::internal::Benchmark* benchmark) {
+    for (auto instructionSet : {anira::simd::InstructionSet::Scalar, anira::simd::InstructionSet::SSE2, anira::simd::InstructionSet::AVX2, anira::simd::InstructionSet::AVX512, anira::simd::InstructionSet::NEON}) {
+        // Only register the instruction sets that are compiled in and supported by this cpu
+        if (anira::simd::getKernels(instructionSet) == nullptr) continue;
+        // Odd buffer sizes are included to see the cost of the scalar tails
+        for (int64_t numSamples : {64, 127, 512, 2048, 8192}) {
+            benchmark->Args({static_cast<int64_t>(instructionSet), numSamples});
+        }
+    }
+}
+
+BENCHMARK(BM_COPY)->Apply(kernelArguments)->Repetitions(NUM_REPETITIONS)->ReportAggregatesOnly(true);
+BENCHMARK(BM_ADD_WITH_GAIN)->Apply(kernelArguments)->Repetitions(NUM_REPETITIONS)->ReportAggregatesOnly(true);
+BENCHMARK(BM_INTERLEAVE)->Apply(kernelArguments)->Repetitions(NUM_REPETITIONS)->ReportAggregatesOnly(true);
+BENCHMARK(BM_DEINTERLEAVE)->Apply(kernelArguments)->Repetitions(NUM_REPETITIONS)->ReportAggregatesOnly(true);
+BENCHMARK(BM_FLOAT_TO_INT16)->Apply(kernelArguments)->Repetitions(NUM_REPETITIONS)->ReportAggregatesOnly(true);
+BENCHMARK(BM_INT16_TO_FLOAT)->Apply(kernelArguments)->Repetitions(NUM_REPETITIONS)->ReportAggregatesOnly(true);
@@ -0,0 +1,16 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+#include <anira/anira.h>
+
+TEST(Benchmark, SimdKernels){
+#if __linux__ || __APPLE__
+    pthread_t self = pthread_self();
+#elif WIN32
+    HANDLE self = GetCurrentThread();
+#endif
+    anira::RealtimeThread::elevateToRealTimePriority(self, true);
+
+    std::cout << "Default instruction set: " << anira::simd::getInstructionSetName(anira::simd::getKernels().instructionSet) << std::endl;
+
+    benchmark::RunSpecifiedBenchmarks();
+}
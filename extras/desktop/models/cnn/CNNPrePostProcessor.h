@@ -4,11 +4,13 @@
 #include "CNNConfig.h"
 #include <anira/anira.h>
 
-class CNNPrePostProcessor : public anira::PrePostProcessor
+class CNNPrePostProcessor : public anira::WindowedPrePostProcessor
 {
 public:
-    virtual void preProcess(anira::RingBuffer& input, anira::AudioBufferF& output, [[maybe_unused]] anira::InferenceBackend currentInferenceBackend) override {
-        popSamplesFromBuffer(input, output, config.m_new_model_output_size, config.m_new_model_input_size-config.m_new_model_output_size);
+    virtual void prepare(anira::HostAudioConfig newConfig) override {
+        // The window is set here and not in the constructor, because the config can be exchanged after construction
+        setWindow(config.m_new_model_input_size, config.m_new_model_output_size);
+        anira::WindowedPrePostProcessor::prepare(newConfig);
     };
 
     anira::InferenceConfig config = cnnConfig;
@@ -7,47 +7,37 @@
 class HybridNNPrePostProcessor : public anira::PrePostProcessor
 {
 public:
-    virtual void preProcess(anira::RingBuffer& input, anira::AudioBufferF& output, [[maybe_unused]] anira::InferenceBackend currentInferenceBackend) override {
-        int64_t num_batches;
-        int64_t num_input_samples;
-        int64_t num_output_samples;
-        if (currentInferenceBackend == anira::LIBTORCH) {
-            num_batches = config.m_model_input_shape_torch[0];
-            num_input_samples = config.m_model_input_shape_torch[2];
-            num_output_samples = config.m_model_output_shape_torch[1];
-        } else if (currentInferenceBackend == anira::ONNX) {
-            num_batches = config.m_model_input_shape_onnx[0];
-            num_input_samples = config.m_model_input_shape_onnx[2];
-            num_output_samples = config.m_model_output_shape_onnx[1];
-        } else if (currentInferenceBackend == anira::TFLITE) {
-            num_batches = config.m_model_input_shape_tflite[0];
-            num_input_samples = config.m_model_input_shape_tflite[1];
-            num_output_samples = config.m_model_output_shape_tflite[1];
-        } else if (currentInferenceBackend == anira::NONE) {
+    // The model predicts one sample per batch from a window of 150 samples, neighbouring windows are shifted by one sample. The number of batches differs between the model variants and is read from the shape.
+    using TorchLayout = anira::TensorLayout<anira::TensorAxes<anira::TensorAxis::Batch, anira::TensorAxis::Channel, anira::TensorAxis::Time>, 150, 1>;
+    using TfLiteLayout = anira::TensorLayout<anira::TensorAxes<anira::TensorAxis::Batch, anira::TensorAxis::Time, anira::TensorAxis::Channel>, 150, 1>;
+
+    virtual void prepare([[maybe_unused]] anira::HostAudioConfig newConfig) override {
+#ifdef USE_LIBTORCH
+        windowExtractor.setLayout<TorchLayout>(anira::LIBTORCH, config.m_model_input_shape_torch, config.m_new_model_output_size);
+#endif
+#ifdef USE_ONNXRUNTIME
+        windowExtractor.setLayout<TorchLayout>(anira::ONNX, config.m_model_input_shape_onnx, config.m_new_model_output_size);
+#endif
+#ifdef USE_TFLITE
+        windowExtractor.setLayout<TfLiteLayout>(anira::TFLITE, config.m_model_input_shape_tflite, config.m_new_model_output_size);
+#endif
 #if USE_LIBTORCH
-            num_batches = config.m_model_input_shape_torch[0];
-            num_input_samples = config.m_model_input_shape_torch[2];
-            num_output_samples = config.m_model_output_shape_torch[1];
+        windowExtractor.setLayout<TorchLayout>(anira::NONE, config.m_model_input_shape_torch, config.m_new_model_output_size);
 #elif USE_ONNXRUNTIME
-            num_batches = config.m_model_input_shape_onnx[0];
-            num_input_samples = config.m_model_input_shape_onnx[2];
-            num_output_samples = config.m_model_output_shape_onnx[1];
+        windowExtractor.setLayout<TorchLayout>(anira::NONE, config.m_model_input_shape_onnx, config.m_new_model_output_size);
 #elif USE_TFLITE
-            num_batches = config.m_model_input_shape_tflite[0];
-            num_input_samples = config.m_model_input_shape_tflite[1];
-            num_output_samples = config.m_model_output_shape_tflite[1];
+        windowExtractor.setLayout<TfLiteLayout>(anira::NONE, config.m_model_input_shape_tflite, config.m_new_model_output_size);
 #endif
-        } else {
-            throw std::runtime_error("Invalid inference backend");
-        }
-            
-        for (size_t batch = 0; batch < num_batches; batch++) {
-            size_t baseIdx = batch * num_input_samples;
-            popSamplesFromBuffer(input, output, num_output_samples, num_input_samples-num_output_samples, baseIdx);
-        }
+    };
+
+    virtual void preProcess(anira::RingBuffer& input, anira::AudioBufferF& output, anira::InferenceBackend currentInferenceBackend) override {
+        windowExtractor.popWindows(currentInferenceBackend, input, output);
     };
     
     anira::InferenceConfig config = hybridNNConfig;
+
+private:
+    anira::WindowExtractor windowExtractor;
 };
 
 #endif //ANIRA_HYBRIDNNPREPOSTPROCESSOR_H
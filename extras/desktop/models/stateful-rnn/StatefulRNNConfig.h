@@ -22,7 +22,7 @@ static anira::InferenceConfig statefulRNNConfig(
 
         42.66f,
         0,
-        false,
+        0,
         0.f,
         true
 );
@@ -2,9 +2,11 @@
 #define ANIRA_INFERENCECONFIG_H
 
 #include <array>
+#include <functional>
 #include <string>
 #include <vector>
 #include <thread>
+#include "utils/InferenceBackend.h"
 #include "anira/system/AniraConfig.h"
 
 namespace anira {
@@ -28,7 +30,7 @@ struct ANIRA_API InferenceConfig {
 #endif
             float max_inference_time = 0, // in ms per input of batch_size
             int model_latency = 0, // in samples per input of batch_size
-            bool warm_up = false,
+            int warm_up = 0, // number of inferences in prepare, true means one
             float wait_in_process_block = 0.f,
             bool bind_session_to_thread = false,
             int numberOfThreads = ((int) std::thread::hardware_concurrency() / 2 > 0) ? (int) std::thread::hardware_concurrency() / 2 : 1) :
@@ -116,7 +118,8 @@ struct ANIRA_API InferenceConfig {
 
     float m_max_inference_time;
     int m_model_latency;
-    bool m_warm_up;
+    // Inferences every backend runs when it is prepared, so lazily allocated runtime buffers are faulted in before the audio starts
+    int m_warm_up;
     float m_wait_in_process_block;
     bool m_bind_session_to_thread;
     int m_number_of_threads;
@@ -124,6 +127,132 @@ struct ANIRA_API InferenceConfig {
     int m_new_model_input_size;
     int m_new_model_output_size;
 
+    // Measure the inference time of every backend that has a model in prepare() instead of trusting m_max_inference_time
+    bool m_calibrate = false;
+    // Number of timed inferences per backend, a tenth of them is run beforehand to warm up and not timed
+    int m_calibration_inferences = 100;
+    // Percentile (0 to 100) of the measured inference times that is used as the max inference time
+    float m_calibration_percentile = 99.f;
+    // If not empty, calibration results are read from and written to this file, keyed by model, backend and cpu
+    std::string m_calibration_cache_path = "";
+
+    // Grow and shrink the latency at runtime following the recent inference times and missed blocks, instead of keeping the latency of prepare().
+    // The session buffers leave room for about one second more than the latency of prepare(), the latency does not grow beyond that.
+    bool m_adaptive_latency = false;
+    // Percentile (0 to 100) of the recent inference and queue wait times the adaptive latency is sized for
+    float m_adaptive_latency_percentile = 99.f;
+
+    // How the channels of a multichannel host are mapped to inferences, mono sessions behave the same in both modes
+    enum ChannelMode {
+        // Every inference holds one channel and the model shapes stay mono, the inference threads run the channels of a block in parallel
+        ChannelParallel,
+        // One inference holds all channels, the model shapes include them (e.g. folded into the batch dimension) and the new model sizes cover all channels
+        ChannelBatched
+    };
+    ChannelMode m_channel_mode = ChannelParallel;
+
+    // The model keeps a hidden state between inferences. The inferences of a session then run one at a time in the order they were submitted, and
+    // without m_bind_session_to_thread every session keeps its own copy of the state that is moved into the backend of the thread that runs the next inference.
+    // This needs a backend that can save and restore the state (BackendBase::getStateSize), so far LibTorch. If a backend with a model can not (ONNX Runtime, TFLite,
+    // or a LibTorch model without state tensors), prepare warns and binds the session to its own thread as with m_bind_session_to_thread, so the state stays in the backend of that thread.
+    bool m_stateful = false;
+    // LibTorch: the attributes that hold the state, as paths from the top module like "hidden" or "rnn.cell". If empty, the state are all float tensor attributes
+    // of the module and its submodules that are neither parameters nor buffers.
+    std::vector<std::string> m_state_attributes;
+
+    // Linux only: run the inference threads under SCHED_DEADLINE instead of SCHED_FIFO. The runtime is sized from the max inference times and the periods of all sessions,
+    // the deadline from the latency budget of the inferences. The kernel then guarantees the cpu bandwidth and keeps a misbehaving model from starving the system.
+    // Needs CAP_SYS_NICE, if the kernel refuses the reservation the threads stay on SCHED_FIFO. Like m_number_of_threads it is taken from the first session of the pool.
+    bool m_deadline_scheduling = false;
+
+    // Where the inference threads may run, the flags can be combined. The cpus are picked from m_affinity_cpus if given, otherwise from the isolated cpus (isolcpus) if there are any,
+    // otherwise from all cpus of the process. The choice is applied whenever a thread starts and reported in WorkerStatistics::cpus. Has no effect on macOS.
+    // SCHED_DEADLINE needs the threads to be allowed on all cpus of their root domain, so with m_deadline_scheduling a restricted affinity usually keeps the threads on SCHED_FIFO.
+    enum AffinityFlags {
+        AffinityNone = 0,
+        // Keep off the core (and its SMT sibling) of the thread that creates the session, usually the audio thread
+        AffinityAvoidCaller = 1,
+        // Pin every thread to its own physical core, SMT siblings are left unused
+        AffinityPhysicalCores = 2,
+        // Only use the cores with the highest capacity on hybrid cpus (P-cores, big cores)
+        AffinityHighCapacity = 4
+    };
+    int m_affinity = AffinityNone;
+    std::vector<int> m_affinity_cpus;
+
+    // What happens when a new inference finds every slot of the session in use, e.g. after the inference threads were held up
+    enum OverflowPolicy {
+        // Output silence for the new window
+        OverflowDropNewest,
+        // Output silence for the oldest window no inference thread has started yet and process the new window in its slot, so the output recovers sooner.
+        // Stateful sessions drop the newest window instead, their inferences must run in order.
+        OverflowDropOldest,
+        // Run the new window through the none processor (bypass) on the audio thread.
+        // Stateful sessions drop the newest window instead, the bypassed window would leave a gap in the order of their inferences.
+        OverflowFallback
+    };
+    OverflowPolicy m_overflow_policy = OverflowDropNewest;
+    // Slots on top of the ones the latency needs, in host buffers worth of inferences. They are only taken while all other slots are in use and are free again once collected.
+    // The reserve is allocated in prepare and does not grow at runtime, allocating on the audio thread would cost more than the slots save.
+    int m_reserve_buffers = 1;
+
+    // Skip the inferences of a session while its input is silent. Once every channel stayed below m_silence_threshold (linear peak) for the model input plus m_silence_hold ms,
+    // the session stops submitting inferences and repeats the output of its last inference on silent input instead, the steady-state response of the model, or zeros if there was none yet.
+    // The pre processor still gets the skipped samples through skipSamples, so the first inference after the silence has the right history. Stateful models keep the state from before the silence.
+    bool m_silence_gate = false;
+    float m_silence_threshold = 1e-5f;
+    float m_silence_hold = 100.f;
+
+    // Run the inferences in process() on the audio thread instead of handing them to the inference threads. The latency then holds no time for the inferences,
+    // only the buffer adaptation and the model latency, so the model must reliably finish within the audio callback. Meant for tiny models and single core targets.
+    bool m_synchronous = false;
+    // Let the audio thread run an inference itself if its output is still missing after m_wait_in_process_block and no inference thread has started it yet,
+    // instead of outputting silence. Like m_synchronous, this loads one more instance of the models for the audio thread.
+    bool m_audio_thread_assist = false;
+
+    // Memory-map the model files read-only and hand the bytes to the backends instead of letting them read the files. All sessions in a process share one mapping
+    // and the page cache shares it between processes. TFLite runs directly on the mapped model, ONNX Runtime does so for models in the ORT format and parses .onnx models
+    // into its own memory, LibTorch always copies the weights. ONNX models with external data files must be loaded from the path. m_map_models_huge_pages asks the kernel to
+    // back the mappings with transparent huge pages (Linux only).
+    bool m_map_models = false;
+    bool m_map_models_huge_pages = false;
+
+    // Keep the real-time data paths in physical memory, so their first touch does not page fault. MemoryLockSession locks the buffers of every session (ring buffers and
+    // inference slots) and the model weights where the backend exposes them (LibTorch). MemoryLockAll additionally locks all current and future pages of the process
+    // (mlockall, Linux only) and is taken from the first session of the pool. Locking is limited by RLIMIT_MEMLOCK, a warning tells when it is too small.
+    enum MemoryLockMode {
+        MemoryLockNone,
+        MemoryLockSession,
+        MemoryLockAll
+    };
+    MemoryLockMode m_memory_lock = MemoryLockNone;
+
+    // Setup every inference thread does on itself before it takes work, see ThreadInitPolicy. The threads are named "anira-worker-<index>".
+    bool m_flush_denormals = true;
+    size_t m_thread_stack_prefault = 128 * 1024;
+    // Called on every inference thread with its index after the setup, again on every restart of the threads (prepare, new sessions). Not compared by operator==.
+    std::function<void(int)> m_thread_init;
+
+    // Returns an empty string for NONE
+    std::string getModelPath(InferenceBackend backend) const {
+        switch (backend) {
+#ifdef USE_LIBTORCH
+            case LIBTORCH:
+                return m_model_path_torch;
+#endif
+#ifdef USE_ONNXRUNTIME
+            case ONNX:
+                return m_model_path_onnx;
+#endif
+#ifdef USE_TFLITE
+            case TFLITE:
+                return m_model_path_tflite;
+#endif
+            default:
+                return "";
+        }
+    }
+
     bool operator==(const InferenceConfig& other) const {
         return
 #ifdef USE_LIBTORCH
@@ -148,7 +277,31 @@ struct ANIRA_API InferenceConfig {
             m_bind_session_to_thread == other.m_bind_session_to_thread &&
             m_number_of_threads == other.m_number_of_threads &&
             m_new_model_input_size == other.m_new_model_input_size &&
-            m_new_model_output_size == other.m_new_model_output_size;
+            m_new_model_output_size == other.m_new_model_output_size &&
+            m_calibrate == other.m_calibrate &&
+            m_calibration_inferences == other.m_calibration_inferences &&
+            m_calibration_percentile == other.m_calibration_percentile &&
+            m_calibration_cache_path == other.m_calibration_cache_path &&
+            m_adaptive_latency == other.m_adaptive_latency &&
+            m_adaptive_latency_percentile == other.m_adaptive_latency_percentile &&
+            m_channel_mode == other.m_channel_mode &&
+            m_stateful == other.m_stateful &&
+            m_state_attributes == other.m_state_attributes &&
+            m_deadline_scheduling == other.m_deadline_scheduling &&
+            m_affinity == other.m_affinity &&
+            m_affinity_cpus == other.m_affinity_cpus &&
+            m_flush_denormals == other.m_flush_denormals &&
+            m_thread_stack_prefault == other.m_thread_stack_prefault &&
+            m_memory_lock == other.m_memory_lock &&
+            m_map_models == other.m_map_models &&
+            m_map_models_huge_pages == other.m_map_models_huge_pages &&
+            m_overflow_policy == other.m_overflow_policy &&
+            m_reserve_buffers == other.m_reserve_buffers &&
+            m_silence_gate == other.m_silence_gate &&
+            m_silence_threshold == other.m_silence_threshold &&
+            m_silence_hold == other.m_silence_hold &&
+            m_synchronous == other.m_synchronous &&
+            m_audio_thread_assist == other.m_audio_thread_assist;
     }
 
     bool operator!=(const InferenceConfig& other) const {
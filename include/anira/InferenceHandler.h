@@ -18,17 +18,41 @@ public:
     void setInferenceBackend(InferenceBackend inferenceBackend);
     InferenceBackend getInferenceBackend();
 
+    // For bounces and freezes: process() blocks until its output is ready and runs as fast as the inference threads allow, the latency only holds the buffer adaptation and the model latency. Must be set before prepare.
+    void setOfflineMode(bool offline);
+    bool isOfflineMode() const;
+
+    // Falls back to a cheaper backend under overload instead of dropping out, must be set before prepare
+    void setDegradationPolicy(const DegradationPolicy& policy);
+    bool isDegraded() const;
+
     void prepare(HostAudioConfig newAudioConfig);
     void process(float ** inputBuffer, const size_t inputSamples); // buffer[channel][index]
 
     int getLatency();
+    // With InferenceConfig::m_calibrate every backend gets its own max inference time and latency, getLatency() follows the current backend
+    int getLatency(InferenceBackend inferenceBackend);
+    float getMaxInferenceTime(InferenceBackend inferenceBackend);
+
+    // Lock-free snapshots that can be taken from any thread, e.g. a GUI timer, while the audio thread is running
+    SessionStatisticsSnapshot getStatistics() const;
+    std::vector<WorkerStatistics> getWorkerStatistics() const;
+
+    // Telemetry events (missing samples, catch up, full inference queue, backend switch) are collected without locking on the audio thread.
+    // By default a background thread prints them, a listener replaces the printing and is called on that thread.
+    void setTelemetryListener(std::function<void(const TelemetryEvent&)> listener);
+    // Hosts that support latency changes at runtime can follow InferenceConfig::m_adaptive_latency with this callback, it is called on the telemetry drainer thread with the new latency in samples
+    void setLatencyListener(std::function<void(int)> listener);
+    // Without auto drain the events stay in the ring until they are polled
+    void setTelemetryAutoDrain(bool autoDrain);
+    bool pollTelemetry(TelemetryEvent& event);
     InferenceManager &getInferenceManager(); // TODO remove
 
 private:
+    // Declared before the manager, so the default backend is only freed after the manager has stopped the inference threads that use it
+    std::unique_ptr<BackendBase> defaultNoneProcessor;
     BackendBase* noneProcessor;
     InferenceManager inferenceManager;
-
-    bool useCustomNoneProcessor = false;
 };
 
 } // namespace anira
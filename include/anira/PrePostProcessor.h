@@ -3,6 +3,8 @@
 
 #include "utils/RingBuffer.h"
 #include "utils/InferenceBackend.h"
+#include "utils/HostAudioConfig.h"
+#include "utils/WindowLayout.h"
 #include "anira/system/AniraConfig.h"
 
 namespace anira {
@@ -13,16 +15,33 @@ public:
     PrePostProcessor() = default;
     ~PrePostProcessor() = default;
 
+    // The ring buffers hold one channel per host channel. The default implementations lay the channels out one after another in the model tensor, [channel, samples], which suits models with the channels folded into the batch dimension.
     virtual void preProcess(RingBuffer& input, AudioBufferF& output, [[maybe_unused]] InferenceBackend currentInferenceBackend);
     virtual void postProcess(AudioBufferF& input, RingBuffer& output, [[maybe_unused]] InferenceBackend currentInferenceBackend);
 
+    // Called from InferenceHandler::prepare before the first preProcess call, so that processors with internal state can allocate and reset it. Not real-time safe.
+    virtual void prepare([[maybe_unused]] HostAudioConfig newConfig);
+    // Called instead of preProcess when the samples of one inference are consumed without running it (e.g. no free inference slot)
+    virtual void skipSamples(RingBuffer& input, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend);
+
+    // Called instead of the methods above when a multichannel session runs with InferenceConfig::ChannelParallel, every inference then holds the given channel only.
+    // The defaults copy that channel the same way the mono defaults do, processors that override the methods above need to override these as well to support the mode.
+    virtual void preProcessChannel(RingBuffer& input, AudioBufferF& output, size_t channel, [[maybe_unused]] InferenceBackend currentInferenceBackend);
+    virtual void postProcessChannel(AudioBufferF& input, RingBuffer& output, size_t channel, [[maybe_unused]] InferenceBackend currentInferenceBackend);
+    virtual void skipChannelSamples(RingBuffer& input, size_t channel, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend);
+
 protected:
+    // Splits the output evenly across the channels of the ring buffer
     void popSamplesFromBuffer(RingBuffer& input, AudioBufferF& output);
 
     void popSamplesFromBuffer(RingBuffer& input, AudioBufferF& output, int numNewSamples, int numOldSamples);
 
     void popSamplesFromBuffer(RingBuffer& input, AudioBufferF& output, int numNewSamples, int numOldSamples, int offset);
 
+    // Pops layout.getNumNewSamples() samples per channel and fills all windows of the layout in one pass. Unless the channels are interleaved (ChannelsLast with more than one channel), each window takes at most two block copies from the ring buffer
+    void popWindowsFromBuffer(RingBuffer& input, AudioBufferF& output, const WindowLayout& layout);
+
+    // Splits the input evenly across the channels of the ring buffer
     void pushSamplesToBuffer(const AudioBufferF& input, RingBuffer& output);
 };
 
@@ -0,0 +1,51 @@
+#ifndef ANIRA_WINDOWEDPREPOSTPROCESSOR_H
+#define ANIRA_WINDOWEDPREPOSTPROCESSOR_H
+
+#include <vector>
+#include "PrePostProcessor.h"
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Pre-processor for models that see a sliding window over the input signal, where each inference only adds a few new samples to the window (e.g. CNNs with a large receptive field).
+// Instead of rebuilding the window from the ring buffer on every inference, the processor keeps the last window in a history that only the new samples are written to.
+// The history is stored twice in a row, so that the current window is always one contiguous block. Every inference still copies the whole window to the model input,
+// the saving is that this is a single SIMD copy without wrap-around handling instead of reading the window sample by sample from the ring buffer.
+// Every host channel has its own history. With InferenceConfig::ChannelBatched the windows of all channels are laid out one after another, [channel, windowSize], numNewSamples is then counted per channel.
+// Models that take several windows per inference use WindowExtractor instead.
+// The history belongs to one session, so every InferenceHandler needs its own instance.
+class ANIRA_API WindowedPrePostProcessor : public PrePostProcessor
+{
+public:
+    WindowedPrePostProcessor() = default;
+    WindowedPrePostProcessor(size_t windowSize, size_t numNewSamples);
+
+    // Changes the window layout, takes effect at the next prepare call
+    void setWindow(size_t windowSize, size_t numNewSamples);
+
+    void prepare(HostAudioConfig newConfig) override;
+    void preProcess(RingBuffer& input, AudioBufferF& output, [[maybe_unused]] InferenceBackend currentInferenceBackend) override;
+    void skipSamples(RingBuffer& input, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend) override;
+    void preProcessChannel(RingBuffer& input, AudioBufferF& output, size_t channel, [[maybe_unused]] InferenceBackend currentInferenceBackend) override;
+    void skipChannelSamples(RingBuffer& input, size_t channel, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend) override;
+
+    size_t getWindowSize() const;
+    size_t getNumNewSamples() const;
+
+protected:
+    // Pops the given number of samples from the channel of the ring buffer and appends them to the history of that channel
+    void pushToHistory(RingBuffer& input, size_t channel, size_t numSamples);
+    // Copies the current window of the channel, oldest sample first, to the output starting at the given sample index
+    void copyWindow(AudioBufferF& output, size_t channel, size_t offset) const;
+
+private:
+    size_t m_window_size = 0;
+    size_t m_num_new_samples = 0;
+
+    AudioBufferF m_history;
+    std::vector<size_t> m_history_pos;
+};
+
+} // namespace anira
+
+#endif //ANIRA_WINDOWEDPREPOSTPROCESSOR_H
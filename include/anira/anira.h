@@ -4,17 +4,34 @@
 #include "InferenceConfig.h"
 #include "InferenceHandler.h"
 #include "PrePostProcessor.h"
+#include "WindowedPrePostProcessor.h"
 #include "backends/LibTorchProcessor.h"
 #include "backends/OnnxRuntimeProcessor.h"
 #include "backends/TFLiteProcessor.h"
+#include "scheduler/DegradationPolicy.h"
 #include "scheduler/InferenceManager.h"
 #include "scheduler/InferenceThread.h"
 #include "scheduler/InferenceThreadPool.h"
 #include "scheduler/SessionElement.h"
+#include "scheduler/SessionStatistics.h"
+#include "scheduler/TelemetryDrainer.h"
+#include "utils/AtomicHistogram.h"
 #include "utils/AudioBuffer.h"
+#include "utils/CalibrationCache.h"
 #include "utils/HostAudioConfig.h"
+#include "utils/MappedFile.h"
 #include "utils/InferenceBackend.h"
+#include "utils/MemoryAllocator.h"
+#include "utils/MemoryArena.h"
+#include "utils/MemoryLock.h"
 #include "utils/RingBuffer.h"
+#include "utils/SimdKernels.h"
+#include "utils/WindowLayout.h"
+#include "utils/TensorLayout.h"
+#include "utils/TelemetryEvent.h"
+#include "utils/TelemetryRing.h"
+#include "utils/Trace.h"
 #include "system/RealtimeThread.h"
+#include "system/CpuTopology.h"
 
 #endif // ANIRA_H
\ No newline at end of file
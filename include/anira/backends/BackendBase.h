@@ -12,6 +12,14 @@ public:
     virtual void prepareToPlay();
     virtual void processBlock(AudioBufferF& input, AudioBufferF& output);
 
+    // Hidden state of stateful models as one flat array, so that a session can continue on the backend instance of another thread (InferenceConfig::m_stateful).
+    // The default has no state.
+    virtual size_t getStateSize();
+    virtual void saveState(float* state);
+    virtual void restoreState(const float* state);
+    // Goes back to the state the model had after loading
+    virtual void resetState();
+
 protected:
     InferenceConfig& inferenceConfig;
 };
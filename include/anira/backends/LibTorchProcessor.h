@@ -20,9 +20,37 @@ public:
     void prepareToPlay() override;
     void processBlock(AudioBufferF& input, AudioBufferF& output) override;
 
+    // The state are the tensor attributes from InferenceConfig::m_state_attributes, e.g. the hidden state a stateful lstm keeps between calls
+    size_t getStateSize() override;
+    void saveState(float* state) override;
+    void restoreState(const float* state) override;
+    void resetState() override;
+
 private:
     torch::jit::script::Module module;
 
+    // Resolves the state attributes and saves the initial state, once
+    void resolveStateAttributes();
+    void reportStateSizeMismatch(const std::string& name, int64_t size, int64_t expectedSize);
+
+    // Resolved in prepareToPlay. The tensor is read from the slot of the object on every access because models may replace it instead of updating it in place,
+    // which is an index into the slots, not a lookup by name.
+    struct StateAttribute {
+        std::string name;
+        c10::intrusive_ptr<c10::ivalue::Object> object;
+        size_t slot;
+        // Number of elements when resolved, a tensor of another size is not saved or restored
+        int64_t size;
+    };
+    std::vector<StateAttribute> stateAttributes;
+    size_t stateSize = 0;
+    bool stateResolved = false;
+    bool stateSizeMismatchReported = false;
+    std::vector<float> initialState;
+
+    // Storage of the parameters and buffers locked with InferenceConfig::m_memory_lock, unlocked in the destructor
+    std::vector<std::pair<const void*, size_t>> lockedWeights;
+
     torch::Tensor inputTensor;
     torch::Tensor outputTensor;
 
@@ -6,6 +6,7 @@
 #include "BackendBase.h"
 #include "../InferenceConfig.h"
 #include "../utils/AudioBuffer.h"
+#include "../utils/MappedFile.h"
 #include <onnxruntime_cxx_api.h>
 
 namespace anira {
@@ -20,6 +21,8 @@ public:
 
 private:
     Ort::Env env;
+    // With InferenceConfig::m_map_models, declared before the session that may use the bytes in place
+    std::shared_ptr<const MappedFile> mappedModel;
     Ort::MemoryInfo memory_info;
     Ort::AllocatorWithDefaultOptions ort_alloc;
     Ort::SessionOptions session_options;
@@ -6,6 +6,7 @@
 #include "BackendBase.h"
 #include "../InferenceConfig.h"
 #include "../utils/AudioBuffer.h"
+#include "../utils/MappedFile.h"
 #include <tensorflow/lite/c_api.h>
 
 namespace anira {
@@ -19,9 +20,11 @@ public:
     void processBlock(AudioBufferF& input, AudioBufferF& output) override;
 
 private:
-    TfLiteModel* model;
-    TfLiteInterpreterOptions* options;
-    TfLiteInterpreter* interpreter;
+    // With InferenceConfig::m_map_models the model points into this mapping
+    std::shared_ptr<const MappedFile> mappedModel;
+    TfLiteModel* model = nullptr;
+    TfLiteInterpreterOptions* options = nullptr;
+    TfLiteInterpreter* interpreter = nullptr;
 
     TfLiteTensor* inputTensor;
     const TfLiteTensor* outputTensor;
@@ -19,6 +19,8 @@ public:
     bool bufferHasBeenProcessed();
     void pushRandomSamplesInBuffer(anira::HostAudioConfig hostAudioConfig);
     int getBufferSize();
+    // Random block size between 1 and the buffer size, for hosts that were prepared with HostAudioConfig::variableBufferSize
+    int getRandomBufferSize();
     int getRepetition();
 
 #if defined(_WIN32) || defined(__APPLE__)
@@ -29,6 +31,10 @@ public:
 
     void repetitionStep();
 
+    // Writes the trace events recorded since the current repetition started as Chrome trace JSON, requires the library to be built with ANIRA_WITH_TRACING.
+    // If the environment variable ANIRA_TRACE_DIR is set, every repetition is dumped into that directory automatically.
+    bool dumpTrace(const std::string& path);
+
     inline static std::unique_ptr<anira::InferenceHandler> m_inferenceHandler = nullptr;
     inline static std::unique_ptr<anira::AudioBuffer<float>> m_buffer = nullptr;
 
@@ -45,6 +51,8 @@ private:
     InferenceConfig m_inferenceConfig;
     HostAudioConfig m_hostAudioConfig;
 
+    std::string getTraceFileName(const ::benchmark::State& state);
+
     void SetUp(const ::benchmark::State& state);
     void TearDown(const ::benchmark::State& state);
 };
@@ -0,0 +1,30 @@
+#ifndef ANIRA_DEGRADATIONPOLICY_H
+#define ANIRA_DEGRADATIONPOLICY_H
+
+#include "../utils/InferenceBackend.h"
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Decides when a session falls back to a cheaper backend under overload and when it returns. The fallback keeps the latency of the selected backend, so the output stays aligned.
+// A lighter model is used by giving the fallback backend its own model path in the InferenceConfig (e.g. a smaller CNN for ONNX), NONE falls back to the noneProcessor.
+struct ANIRA_API DegradationPolicy {
+    bool enabled = false;
+    InferenceBackend fallbackBackend = NONE;
+
+    // Fall back after this many missed blocks in a row, 0 only uses the prediction
+    int maxConsecutiveMisses = 3;
+    // Fall back before a block is missed when this percentile (0 to 100) of the recent inference plus queue wait times exceeds overloadRatio of the time one inference may take, 0 disables the prediction
+    float percentile = 99.f;
+    float overloadRatio = 0.9f;
+
+    // Seconds on the fallback before the selected backend is tried again. The time doubles up to maxRecoveryTime when the selected backend overloads again within the recovery time.
+    float recoveryTime = 5.f;
+    float maxRecoveryTime = 60.f;
+    // The selected backend is only tried again when the fallback itself needs less than this ratio of the time one inference may take, which indicates that the cpu contention is gone
+    float recoveryRatio = 0.5f;
+};
+
+} // namespace anira
+
+#endif //ANIRA_DEGRADATIONPOLICY_H
@@ -3,6 +3,9 @@
 
 #include "InferenceThread.h"
 #include "InferenceThreadPool.h"
+#include "TelemetryDrainer.h"
+#include "DegradationPolicy.h"
+#include "../utils/CalibrationCache.h"
 #include "../utils/HostAudioConfig.h"
 #include "../InferenceConfig.h"
 #include "../PrePostProcessor.h"
@@ -19,9 +22,21 @@ public:
     void process(float ** inputBuffer, size_t inputSamples);
 
     void setBackend(InferenceBackend newInferenceBackend);
+    // The backend selected with setBackend, the session runs on the fallback backend instead while it is degraded
     InferenceBackend getBackend();
 
+    // In offline mode process() blocks until its output is ready, so the latency only holds the buffer adaptation and the model latency. Must be set before prepare.
+    void setOfflineMode(bool offline);
+    bool isOfflineMode() const;
+
+    // Must be set before prepare
+    void setDegradationPolicy(const DegradationPolicy& policy);
+    bool isDegraded() const;
+
     int getLatency() const;
+    // Latency of the session with the given backend, only differs between the backends after calibration
+    int getLatency(InferenceBackend backend) const;
+    float getMaxInferenceTime(InferenceBackend backend) const;
 
     // Required for unit test
     size_t getNumReceivedSamples();
@@ -29,12 +44,30 @@ public:
 
     int getMissingBlocks();
     int getSessionID() const;
+    SessionStatisticsSnapshot getStatistics() const;
+
+    void setTelemetryListener(TelemetryDrainer::Listener listener);
+    // Called on the telemetry drainer thread with the new latency in samples whenever the adaptive latency or a backend switch changed it
+    void setLatencyListener(std::function<void(int)> listener);
+    void setTelemetryAutoDrain(bool autoDrain);
+    bool pollTelemetry(TelemetryEvent& event);
 
 private:
     void processInput(float ** inputBuffer, const size_t inputSamples);
     void processOutput(float ** inputBuffer, const size_t inputSamples);
     void clearBuffer(float ** inputBuffer, const size_t inputSamples);
-    int calculateLatency();
+    void calibrate();
+    void adaptLatency(InferenceBackend newBackend);
+    LatencyBreakdown calculateLatency(InferenceBackend backend);
+    LatencyBreakdown calculateLatency(float maxInferenceTime);
+    void updateAdaptiveLatency(size_t inputSamples);
+    bool applyLatencyChange(float ** outputBuffer, size_t outputSamples);
+    void latencyChanged(int difference);
+    void updateTelemetryListener();
+    void updateDegradation(size_t inputSamples);
+    void enterFallback();
+    void leaveFallback();
+    float getInferenceDeadline() const;
     int calculateBufferAdaptation(int hostBufferSize, int modelOutputSize);
     int maxNumberOfInferences(int hostBufferSize, int modelOutputSize);
     int greatestCommonDivisor(int a, int b);
@@ -47,8 +80,51 @@ private:
     SessionElement& session;
     HostAudioConfig spec;
 
-    size_t initSamples = 0;
-    std::atomic<int> inferenceCounter {0};
+    std::atomic<size_t> initSamples {0};
+    std::array<LatencyBreakdown, NONE + 1> latencies;
+    // The backend whose latency is currently in the receive buffer, only touched on the audio thread after prepare
+    InferenceBackend latencyBackend = NONE;
+    bool calibrated = false;
+    bool offlineMode = false;
+    // Lends its backends to the audio thread for InferenceConfig::m_synchronous and m_audio_thread_assist, it is never started
+    std::unique_ptr<InferenceThread> callbackWorker;
+
+    // Adaptive latency, only touched on the audio thread
+    static constexpr double ADAPTIVE_LATENCY_INTERVAL = 1.0; // seconds between two evaluations of the statistics
+    static constexpr int ADAPTIVE_LATENCY_SHRINK_INTERVALS = 3; // evaluations in a row that must allow a lower latency before shrinking
+    static constexpr double ADAPTIVE_LATENCY_MAX_SILENCE_WAIT = 2.0; // seconds a shrink waits for a silent block before it crossfades anyway
+    static constexpr float ADAPTIVE_LATENCY_SILENCE_THRESHOLD = 1e-4f;
+    static constexpr size_t ADAPTIVE_LATENCY_FADE_LENGTH = 64;
+    static constexpr uint64_t ADAPTIVE_LATENCY_MIN_INFERENCES = 10;
+    HistogramSnapshot lastInferenceTime;
+    HistogramSnapshot lastQueueWaitTime;
+    size_t samplesSinceEvaluation = 0;
+    size_t samplesWaitingForSilence = 0;
+    int shrinkIntervals = 0;
+    int pendingLatencyChange = 0;
+    bool fadeInPending = false;
+    bool lastBlockSilent = false;
+    AudioBufferF latencyChangeBuffer;
+
+    // Degradation, the state except the flags is only touched on the audio thread
+    static constexpr double DEGRADATION_INTERVAL = 0.25; // seconds between two predictions from the statistics
+    std::atomic<InferenceBackend> selectedBackend {NONE};
+    std::atomic<bool> degraded {false};
+    DegradationPolicy degradationPolicy;
+    HistogramSnapshot degradationInferenceTime;
+    HistogramSnapshot degradationQueueWaitTime;
+    size_t samplesSinceDegradationCheck = 0;
+    size_t samplesDegraded = 0;
+    size_t samplesSinceRecovery = 0;
+    float recoveryTime = 0.f;
+    int consecutiveMisses = 0;
+    int maxInferencesPerBuffer = 1;
+
+    TelemetryDrainer::Listener telemetryListener;
+    std::function<void(int)> latencyListener;
+    std::atomic<int> missingSamples {0};
+
+    TelemetryDrainer telemetryDrainer;
 };
 
 } // namespace anira
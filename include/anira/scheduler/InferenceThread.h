@@ -3,9 +3,9 @@
 
 #ifdef USE_SEMAPHORE
     #include <semaphore>
-#else
-    #include <atomic>
 #endif
+#include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -22,6 +22,7 @@
 #include "../system/RealtimeThread.h"
 #include "../backends/BackendBase.h"
 #include "SessionElement.h"
+#include "SessionStatistics.h"
 #include "../utils/AudioBuffer.h"
 
 namespace anira {
@@ -39,10 +40,27 @@ public:
 
     void run() override;
     int getSessionID() const { return sessionID; }
+    WorkerStatistics getStatistics() const;
+    // Resets the backends of this thread and copies their initial state into the session, for InferenceConfig::m_stateful. The thread must be stopped.
+    void initializeState(SessionElement& session);
+    // Runs a slot the caller has claimed on the calling thread with the backends of this instance, the done flag is left to the caller.
+    // Used on the audio thread with an instance that is never started, see InferenceConfig::m_synchronous.
+    void processSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot);
 
 private:
+    void yieldUnlessDeadlineScheduled();
     bool tryInference(std::shared_ptr<SessionElement> session);
-    void inference(std::shared_ptr<SessionElement> session, AudioBufferF& input, AudioBufferF& output);
+    SessionElement::ThreadSafeStruct& acquireReadySlot(SessionElement& session);
+    SessionElement::ThreadSafeStruct& acquireNextSlot(SessionElement& session);
+    void inference(SessionElement& session, SessionElement::ThreadSafeStruct& slot);
+    void inference(SessionElement& session, AudioBufferF& input, AudioBufferF& output);
+    void restoreState(SessionElement& session, SessionElement::ThreadSafeStruct& slot, InferenceBackend backend);
+    void saveState(SessionElement& session, SessionElement::ThreadSafeStruct& slot, InferenceBackend backend);
+
+    // Calls function with the backend instance of this thread if the backend can save and restore the state of stateful models, so far only LibTorch.
+    // ONNX Runtime sessions keep no state between runs and the TFLite C api does not reach the variable tensors of the interpreter.
+    template <typename Function>
+    void withBackend(InferenceBackend backend, Function&& function);
 
 private:
 #ifdef USE_SEMAPHORE
@@ -53,6 +71,13 @@ private:
     std::vector<std::shared_ptr<SessionElement>>& sessions;
     int sessionID = -1;
 
+    std::atomic<uint64_t> m_cpu_time {0};
+    std::atomic<uint64_t> m_busy_time {0};
+    std::atomic<uint64_t> m_num_inferences {0};
+
+    // Per backend, the session state whose values the backend instance currently holds
+    std::array<const float*, NONE + 1> m_loaded_states {};
+
 #ifdef USE_LIBTORCH
     LibtorchProcessor torchProcessor;
 #endif
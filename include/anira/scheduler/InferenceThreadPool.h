@@ -13,6 +13,7 @@
 #include "InferenceThread.h"
 #include "../PrePostProcessor.h"
 #include "../utils/HostAudioConfig.h"
+#include "../system/CpuTopology.h"
 
 namespace anira {
 
@@ -27,8 +28,16 @@ public:
     static void releaseThreadPool();
 
     void prepare(SessionElement& session, HostAudioConfig newConfig);
+    // Runs numInferences inferences with the given backend one after another on the inference threads and returns the time each spent in the backend in ms.
+    // Only call this from prepare, the audio thread must not process the session meanwhile. Stops early if an inference does not finish within 10 s.
+    std::vector<float> measureInferenceTimes(SessionElement& session, InferenceBackend backend, size_t numInferences);
+
+    // Sizes the SCHED_DEADLINE reservation of every inference thread for the sessions it serves, does nothing without InferenceConfig::m_deadline_scheduling
+    static void updateDeadlineScheduling();
 
     static int getNumberOfSessions();
+    // One entry per inference thread, must not be called while sessions are created or released
+    static std::vector<WorkerStatistics> getWorkerStatistics();
 
 #ifdef USE_SEMAPHORE
     inline static std::counting_semaphore<UINT16_MAX> global_counter{0};
@@ -37,6 +46,13 @@ public:
 #endif
     void newDataSubmitted(SessionElement& session);
     void newDataRequest(SessionElement& session, double bufferSizeInSec);
+    // Offline counterparts that never drop or zero samples: submitting waits for a free slot and requesting waits until numSamples are in the receive buffer
+    void newDataSubmittedBlocking(SessionElement& session);
+    void newDataRequestBlocking(SessionElement& session, size_t numSamples);
+    // InferenceConfig::m_synchronous, runs every complete window on the calling thread with the backends of worker and collects it right away
+    void newDataProcessedSynchronous(SessionElement& session, InferenceThread& worker);
+    // InferenceConfig::m_audio_thread_assist, runs the inferences the output of the next numSamples still waits for on the calling thread, as long as no inference thread has started them
+    void newDataRequestAssisted(SessionElement& session, InferenceThread& worker, size_t numSamples);
 
     static std::vector<std::shared_ptr<SessionElement>>& getSessions();
 
@@ -44,8 +60,38 @@ private:
     inline static std::shared_ptr<InferenceThreadPool> inferenceThreadPool = nullptr; 
     static int getAvailableSessionID();
 
-    static bool preProcess(SessionElement& session);
+    // Fills a free slot with the next inference of the channel, with batched channels the channel is ignored and the slot holds all of them.
+    // If no slot is free, InferenceConfig::m_overflow_policy decides, returns false if the window has to be dropped.
+    static bool preProcess(SessionElement& session, size_t channel);
+    // Pre processes the next window into the slot and gives it the next time stamp
+    static void fillSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot, size_t channel);
+    // Hands the slot to the inference threads, newJob is false if the job of the slot was taken from the counters before
+    static void submitSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot, bool newJob);
+    static SessionElement::ThreadSafeStruct* acquireOverflowSlot(SessionElement& session);
+    // InferenceConfig::OverflowDropOldest and InferenceConfig::OverflowFallback, return false if they can not help either
+    static bool dropOldestInference(SessionElement& session, size_t channel);
+    static bool processInline(SessionElement& session, size_t channel);
+    // Consumes the samples of an inference that could not be submitted and outputs silence instead
+    static void skipInference(SessionElement& session, size_t channel);
+    // Pushes one window of zeros for the channel, or for all channels unless they are parallel
+    static void outputSilence(SessionElement& session, size_t channel);
+    // InferenceConfig::m_silence_gate, consumes the next round without submitting it if the input has been silent long enough
+    static bool skipSilentRound(SessionElement& session);
+    // Outputs the cached response to silence for the rounds of the oldest time stamp if they were skipped, returns false otherwise
+    static bool emitSilentRounds(SessionElement& session);
     static void postProcess(SessionElement& session, SessionElement::ThreadSafeStruct& nextBuffer);
+    // Takes a submitted slot away from the inference threads the same way they take it, returns false if one of them has picked it up already
+    static bool claimSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot);
+    // Waits until the oldest submitted slot is done and collects it, returns false if no slot is in flight
+    static bool collectOldest(SessionElement& session);
+    // Removes the slots of the session that no inference thread has picked up yet from the global counter, so the other sessions keep their pending work. The inference threads must be stopped.
+    static void discardPendingInferences(SessionElement& session);
+    // InferenceConfig::m_stateful needs a backend that can save the state (BackendBase::getStateSize), otherwise the session is bound to its own thread (SessionElement::boundToThread). The threads must be stopped.
+    static void bindStatelessSession(SessionElement& session);
+    // Hands the ThreadInitPolicy of the config to the last created inference thread
+    static void setInitPolicy(InferenceConfig& config);
+    // Chooses the cpus of every inference thread following InferenceConfig::m_affinity, the threads must be stopped and pick them up on their next start
+    static void assignAffinity();
 
 private:
 
@@ -53,6 +99,13 @@ private:
     inline static std::atomic<int> nextId{0};
     inline static std::atomic<int> activeSessions{0};
     inline static bool threadPoolShouldExit = false;
+    inline static bool deadlineScheduling = false;
+    inline static int affinity = InferenceConfig::AffinityNone;
+    inline static std::vector<int> affinityCpus;
+    // Cpu of the thread that created the pool, kept clear with InferenceConfig::AffinityAvoidCaller
+    inline static int callerCpu = -1;
+    // Headroom of the runtime over the mean cpu time the sessions need per period
+    static constexpr double DEADLINE_RUNTIME_HEADROOM = 1.5;
 
     inline static std::vector<std::unique_ptr<InferenceThread>> threadPool;
 };
@@ -4,11 +4,18 @@
 #ifdef USE_SEMAPHORE
     #include <semaphore>
 #endif
+#include <array>
 #include <atomic>
 #include <queue>
+#include <chrono>
 
 #include "../utils/AudioBuffer.h"
 #include "../utils/RingBuffer.h"
+#include "../utils/MemoryArena.h"
+#include "../utils/TelemetryRing.h"
+#include "../utils/Trace.h"
+#include "../utils/WaitableFlag.h"
+#include "SessionStatistics.h"
 #include "../utils/InferenceBackend.h"
 #include "../utils/HostAudioConfig.h"
 #include "../backends/BackendBase.h"
@@ -20,11 +27,14 @@ namespace anira {
 struct ANIRA_API SessionElement {
     SessionElement(int newSessionID, PrePostProcessor& prePostProcessor, InferenceConfig& config, BackendBase& noneProcessor);
 
+    // All buffers of the session live in this arena, it must be declared before the buffers so that it is destroyed after them
+    MemoryArena memoryArena;
+
     RingBuffer sendBuffer;
     RingBuffer receiveBuffer;
 
     struct ThreadSafeStruct {
-        ThreadSafeStruct(size_t model_input_size, size_t model_output_size);
+        ThreadSafeStruct(size_t model_input_size, size_t model_output_size, MemoryAllocator& allocator);
 #ifdef USE_SEMAPHORE
         std::binary_semaphore free{true};
         std::binary_semaphore ready{false};
@@ -32,9 +42,18 @@ struct ANIRA_API SessionElement {
 #else
         std::atomic<bool> free{true};
         std::atomic<bool> ready{false};
-        std::atomic<bool> done{false};
+        // Can be waited on with a deadline, so m_wait_in_process_block also works without semaphores
+        WaitableFlag done;
 #endif
         unsigned long timeStamp;
+        // The host channel the slot holds with InferenceConfig::ChannelParallel, unused otherwise
+        size_t channel = 0;
+        // Set when the slot is handed to the inference threads, for the queue wait statistics
+        std::chrono::steady_clock::time_point submitTime;
+        // Time the worker spent in the backend, in nanoseconds, valid once done is set
+        uint64_t inferenceTime = 0;
+        // The whole model input was below the silence threshold, the output is kept as the response to silence
+        bool silentInput = false;
         AudioBufferF processedModelInput = AudioBufferF();
         AudioBufferF rawModelOutput = AudioBufferF();
     };
@@ -42,8 +61,39 @@ struct ANIRA_API SessionElement {
     // avoids issues with copying or moving objects containing std::binary_semaphore members,
     // which would otherwise prevent the generation of copy constructors.
     std::vector<std::unique_ptr<ThreadSafeStruct>> inferenceQueue;
+    // The inference threads work on the first numThreadSlots slots, the last numReserveSlots of them are only taken when the others are in use.
+    // The slots after them are filled on the audio thread by InferenceConfig::m_overflow_policy.
+    size_t numThreadSlots = 0;
+    size_t numReserveSlots = 0;
+
+    // Set in prepare. Every inference round consumes numNewSamples samples from each host channel, with channelParallel a round takes one slot per channel, otherwise one slot for all channels.
+    size_t numChannels = 1;
+    size_t numNewSamples = 0;
+    bool channelParallel = false;
+    size_t getNumSlotsPerRound() const {
+        return channelParallel ? numChannels : 1;
+    }
+
+    // InferenceConfig::m_silence_gate. A time stamp with this bit set stands for the number of rounds in the other bits that were skipped because the input was silent.
+    static constexpr unsigned long SILENT_ROUNDS = 1ul << 31;
+    // Consecutive input samples per channel below the threshold, the number the model input covers and the number it takes to close the gate, set in prepare
+    size_t silentSamples = 0;
+    size_t silenceInputSamples = 0;
+    size_t silenceGateSamples = 0;
+    // Output of the last inference on silent input for each slot of a round
+    std::vector<AudioBufferF> silenceResponses;
+    std::vector<bool> hasSilenceResponse;
+
+    // Set in prepare
+    HostAudioConfig hostConfig {0, 0, 0.};
+    // Largest total latency in samples the receive buffer is sized for, set in prepare. InferenceConfig::m_adaptive_latency does not grow beyond it.
+    size_t maxLatency = 0;
+    // Time in ms one inference may take at the latency of prepare, set by the InferenceManager
+    float inferenceDeadline = 0.f;
 
     std::atomic<InferenceBackend> currentBackend {NONE};
+    // Max inference time of each backend in ms, either m_max_inference_time or the calibrated value. The queue is sized for the slowest backend.
+    std::array<float, NONE + 1> maxInferenceTimes;
     unsigned long m_current_queue = 0;
     std::vector<unsigned long> timeStamps;
 
@@ -52,9 +102,25 @@ struct ANIRA_API SessionElement {
 #else
     std::atomic<int> m_session_counter{0};
 #endif
+
+    // InferenceConfig::m_stateful: only the thread that holds stateLocked runs inferences of the session, the members below are only accessed with it held
+    std::atomic<bool> stateLocked {false};
+    // Time stamp of the next inference, so they run in the order they were submitted
+    unsigned long nextStatefulTimeStamp = 0;
+    // Hidden state of each backend, with channelParallel one state per channel one after another, empty if the backend has no state
+    std::array<std::vector<float>, NONE + 1> states;
+    // Per channel, the thread whose backend instance held the state last, it can skip restoring it
+    std::vector<const void*> stateOwners;
+    // Only the thread of the session runs its inferences, from InferenceConfig::m_bind_session_to_thread or set by prepare for stateful models whose backend can not save the state.
+    // Written while the inference threads are stopped.
+    bool boundToThread;
     
     const int sessionID;
 
+    // Warnings and state changes of the session, written on the audio thread and consumed by a TelemetryDrainer or InferenceHandler::pollTelemetry
+    TelemetryRing telemetry;
+    SessionStatistics statistics;
+
     PrePostProcessor& prePostProcessor;
     InferenceConfig& inferenceConfig;
     BackendBase& noneProcessor;
@@ -0,0 +1,116 @@
+#ifndef ANIRA_SESSIONSTATISTICS_H
+#define ANIRA_SESSIONSTATISTICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "../utils/AtomicHistogram.h"
+#include "../utils/InferenceBackend.h"
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// The parts of the latency that InferenceManager::calculateLatency adds up, all in samples
+struct ANIRA_API LatencyBreakdown {
+    int bufferAdaptation = 0;
+    int inferenceCausedLatency = 0;
+    int modelLatency = 0;
+    int totalLatency = 0;
+};
+
+struct ANIRA_API SessionStatisticsSnapshot {
+    // Time a worker spent in the backend per inference, in nanoseconds
+    HistogramSnapshot inferenceTime;
+    // Time between handing a slot to the workers and a worker picking it up, in nanoseconds
+    HistogramSnapshot queueWaitTime;
+
+    uint64_t numInferences = 0;
+    uint64_t missedBlocks = 0;
+    uint64_t caughtUpBlocks = 0;
+    // Inferences that found all regular slots in use, the ones that found the reserve slots in use as well and what InferenceConfig::m_overflow_policy did with them
+    uint64_t reserveSlotsUsed = 0;
+    uint64_t queueFullEvents = 0;
+    uint64_t droppedInferences = 0;
+    uint64_t inlineFallbacks = 0;
+    // Inferences the silence gate (InferenceConfig::m_silence_gate) did not run
+    uint64_t silentInferences = 0;
+    // Inferences the audio thread ran itself because no inference thread had started them in time (InferenceConfig::m_audio_thread_assist)
+    uint64_t assistedInferences = 0;
+
+    // Inference slots that are currently submitted or waiting to be collected, the maximum since the last prepare call and the number of slots
+    size_t occupiedSlots = 0;
+    size_t maxOccupiedSlots = 0;
+    size_t numSlots = 0;
+
+    InferenceBackend backend = NONE;
+    LatencyBreakdown latency;
+
+    // The session runs on the fallback backend of its DegradationPolicy
+    bool degraded = false;
+    uint64_t numFallbacks = 0;
+};
+
+// Counters of one inference thread, the cpu time is the time the operating system scheduled the thread (not the wall-clock time), all in nanoseconds
+struct ANIRA_API WorkerStatistics {
+    uint64_t cpuTime = 0;
+    uint64_t busyTime = 0;
+    uint64_t numInferences = 0;
+    // Logical cpus the operating system lets the thread run on, all allowed cpus if the thread is not pinned
+    std::vector<int> cpus;
+};
+
+// Counters of one session. They are written on the audio thread and the inference threads with relaxed atomics and can be read at any time from any thread (e.g. a GUI timer) without disturbing the writers.
+class ANIRA_API SessionStatistics {
+public:
+    SessionStatistics() = default;
+
+    SessionStatistics(const SessionStatistics&) = delete;
+    SessionStatistics& operator=(const SessionStatistics&) = delete;
+
+    // Called from prepare while the inference threads are stopped
+    void reset(size_t numSlots);
+    void setLatency(const LatencyBreakdown& latency);
+
+    void recordInference(uint64_t inferenceTime, uint64_t queueWaitTime);
+    void recordMissedBlock();
+    void recordCaughtUpBlock();
+    void recordQueueFull();
+    void recordReserveSlotUsed();
+    void recordDroppedInference();
+    void recordInlineFallback();
+    void recordSilentInferences(uint64_t numInferences);
+    void recordAssistedInference();
+    void slotSubmitted();
+    void slotCollected();
+    void setDegraded(bool degraded);
+
+    SessionStatisticsSnapshot getSnapshot(InferenceBackend backend) const;
+
+private:
+    AtomicHistogram m_inference_time;
+    AtomicHistogram m_queue_wait_time;
+
+    std::atomic<uint64_t> m_missed_blocks {0};
+    std::atomic<uint64_t> m_caught_up_blocks {0};
+    std::atomic<uint64_t> m_queue_full_events {0};
+    std::atomic<uint64_t> m_reserve_slots_used {0};
+    std::atomic<uint64_t> m_dropped_inferences {0};
+    std::atomic<uint64_t> m_inline_fallbacks {0};
+    std::atomic<uint64_t> m_silent_inferences {0};
+    std::atomic<uint64_t> m_assisted_inferences {0};
+    std::atomic<bool> m_degraded {false};
+    std::atomic<uint64_t> m_num_fallbacks {0};
+
+    std::atomic<size_t> m_occupied_slots {0};
+    std::atomic<size_t> m_max_occupied_slots {0};
+    std::atomic<size_t> m_num_slots {0};
+
+    std::atomic<int> m_buffer_adaptation {0};
+    std::atomic<int> m_inference_caused_latency {0};
+    std::atomic<int> m_model_latency {0};
+    std::atomic<int> m_total_latency {0};
+};
+
+} // namespace anira
+
+#endif //ANIRA_SESSIONSTATISTICS_H
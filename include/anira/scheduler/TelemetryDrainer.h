@@ -0,0 +1,50 @@
+#ifndef ANIRA_TELEMETRYDRAINER_H
+#define ANIRA_TELEMETRYDRAINER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "../utils/TelemetryRing.h"
+
+namespace anira {
+
+// Background thread that empties the telemetry ring of one session in a fixed interval and hands the events to a listener, or prints them when no listener is set. This moves all console output and user callbacks off the audio thread.
+class ANIRA_API TelemetryDrainer {
+public:
+    using Listener = std::function<void(const TelemetryEvent&)>;
+
+    TelemetryDrainer(TelemetryRing& ring);
+    ~TelemetryDrainer();
+
+    TelemetryDrainer(const TelemetryDrainer&) = delete;
+    TelemetryDrainer& operator=(const TelemetryDrainer&) = delete;
+
+    void start();
+    // Stops the thread and drains the remaining events
+    void stop();
+    bool isRunning();
+
+    // The listener is called on the drainer thread (or on the thread calling drain), an empty listener restores the console output
+    void setListener(Listener listener);
+    // Hands all pending events to the listener on the calling thread
+    void drain();
+
+    static void print(const TelemetryEvent& event);
+
+private:
+    void run();
+
+    static constexpr std::chrono::milliseconds DRAIN_INTERVAL {50};
+
+    TelemetryRing& m_ring;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running = false;
+    Listener m_listener;
+};
+
+} // namespace anira
+
+#endif //ANIRA_TELEMETRYDRAINER_H
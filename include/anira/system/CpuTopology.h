@@ -0,0 +1,51 @@
+#ifndef ANIRA_SYSTEM_CPUTOPOLOGY_H
+#define ANIRA_SYSTEM_CPUTOPOLOGY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "AniraConfig.h"
+
+namespace anira {
+
+struct ANIRA_API CpuInfo {
+    // Logical cpu number as used by the affinity apis
+    int id = 0;
+    // Logical cpus with the same core are SMT siblings that share the execution units, it is the lowest id among them
+    int core = 0;
+    // Relative performance, higher is faster. From cpu_capacity on big.LITTLE, 1024 for P-cores and 512 for E-cores on Intel hybrid cpus and the EfficiencyClass on Windows.
+    int capacity = 1024;
+};
+
+// Logical cpus of the machine, read from sysfs on Linux and from GetLogicalProcessorInformationEx on Windows. Elsewhere every logical cpu counts as its own core of equal capacity.
+class ANIRA_API CpuTopology {
+public:
+    static CpuTopology detect();
+
+    const std::vector<CpuInfo>& getCpus() const { return m_cpus; }
+    const CpuInfo* getCpu(int id) const;
+
+    // The cpus the process may run on
+    const std::vector<int>& getAllowedCpus() const { return m_allowed; }
+    // Cpus the kernel keeps free of other work (isolcpus), empty if there are none
+    const std::vector<int>& getIsolatedCpus() const { return m_isolated; }
+
+    // Cpus for each of numThreads inference threads following the InferenceConfig::AffinityFlags, an empty set leaves the thread unrestricted.
+    // callerCpu is the cpu the creating thread runs on, explicitCpus restricts the choice if not empty.
+    std::vector<std::vector<int>> selectCpus(int affinityFlags, const std::vector<int>& explicitCpus, int callerCpu, size_t numThreads) const;
+
+    // Returns -1 if unknown
+    static int getCurrentCpu();
+    // Parses lists like "0-3,8,10-11"
+    static std::vector<int> parseCpuList(const std::string& list);
+
+private:
+    std::vector<CpuInfo> m_cpus;
+    std::vector<int> m_allowed;
+    std::vector<int> m_isolated;
+};
+
+} // namespace anira
+
+#endif // ANIRA_SYSTEM_CPUTOPOLOGY_H
@@ -10,29 +10,83 @@
     #include <pthread.h>
     #include <sys/qos.h>
 #endif
+#include <atomic>
 #include <thread>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "AniraConfig.h"
 
 namespace anira {
 
+// Setup a RealtimeThread does on itself when it starts, before run(), so nothing of it leaks into the creating thread or the rest of the process
+struct ANIRA_API ThreadInitPolicy {
+    // Shown in debuggers and profilers, Linux cuts it to 15 characters
+    std::string name;
+    // Flush denormals to zero (FTZ/DAZ) on x86 and arm, decaying filter or rnn states otherwise end up in the slow denormal path
+    bool flushDenormals = true;
+    // Bytes of stack touched up front, so the first calls do not page fault
+    size_t stackPrefaultSize = 0;
+    // Called last, on the new thread
+    std::function<void()> hook;
+};
+
 class ANIRA_API RealtimeThread {
 public:
     RealtimeThread();
     ~RealtimeThread();
     
+    // Returns once the new thread has applied its ThreadInitPolicy, priority, affinity and deadline scheduling
     void start();
     void stop();
 
+    // Takes effect on the next start
+    void setInitPolicy(const ThreadInitPolicy& policy);
+
     virtual void run() = 0;
 
+    // Without SCHED_FIFO the nice value is raised instead, which is only possible if thread_native_handle is the calling thread
     static void elevateToRealTimePriority(std::thread::native_handle_type thread_native_handle, bool is_main_process = false);
+    static void flushDenormalsToZero();
+    static void prefaultStack(size_t size);
+    static void setCurrentThreadName(const std::string& name);
     bool shouldExit();
 
+    // Linux only: runs the thread under SCHED_DEADLINE with the given reservation in ns, applied right away if the thread runs and again on every start.
+    // Returns false if the kernel refuses it (missing CAP_SYS_NICE, failed admission control or a restricted cpu affinity), the thread then keeps SCHED_FIFO or the raised nice value.
+    // A period of 0 switches back to SCHED_FIFO.
+    bool setDeadlineScheduling(uint64_t runtime, uint64_t deadline, uint64_t period);
+    bool isDeadlineScheduled() const;
+
+    // Restricts the thread to the given logical cpus from the next start on, an empty set keeps the affinity the new thread inherits. Not supported on macOS.
+    void setAffinity(const std::vector<int>& cpus);
+    // The cpus the operating system lets the thread run on, empty if unknown
+    std::vector<int> getAffinity() const;
+
+    // Returns the cpu time the calling thread has consumed so far in nanoseconds
+    static uint64_t getCurrentThreadCpuTime();
+
 private:
+    void initialize();
+    bool applyDeadlineScheduling();
+    void applyAffinity();
+
     std::thread thread;
     std::atomic<bool> m_should_exit;
+
+    std::atomic<uint64_t> m_deadline_runtime {0};
+    std::atomic<uint64_t> m_deadline_deadline {0};
+    std::atomic<uint64_t> m_deadline_period {0};
+    std::atomic<bool> m_deadline_active {false};
+    // Kernel thread id, SCHED_DEADLINE can not be set through the pthread api
+    std::atomic<int> m_tid {0};
+
+    std::vector<int> m_affinity;
+    ThreadInitPolicy m_init_policy;
+    std::atomic<bool> m_initialized {false};
 };
 
 } // namespace anira
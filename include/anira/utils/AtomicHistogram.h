@@ -0,0 +1,54 @@
+#ifndef ANIRA_ATOMICHISTOGRAM_H
+#define ANIRA_ATOMICHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Copy of an AtomicHistogram at one point in time. Durations are in nanoseconds.
+struct ANIRA_API HistogramSnapshot {
+    // Bucket 0 holds everything below 1 us, above that every octave is split into 4 buckets, the last bucket ends at about 14 s
+    static constexpr size_t NUM_BUCKETS = 96;
+
+    std::array<uint64_t, NUM_BUCKETS> buckets {};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+
+    double getMean() const;
+    // Returns the upper bound of the bucket that holds the given percentile (0 to 100), clamped to the maximum
+    double getPercentile(double percentile) const;
+
+    // Returns the values recorded between the older snapshot and this one, so percentiles can be computed over a time window. min and max become the bounds of the outermost non-empty buckets.
+    HistogramSnapshot since(const HistogramSnapshot& older) const;
+
+    static size_t getBucketIndex(uint64_t value);
+    static uint64_t getBucketLowerBound(size_t index);
+    static uint64_t getBucketUpperBound(size_t index);
+};
+
+// Fixed-bucket histogram for durations that can be written from several threads and read from any thread without locks. Recording is a handful of relaxed atomic operations.
+class ANIRA_API AtomicHistogram {
+public:
+    AtomicHistogram();
+
+    void record(uint64_t value);
+    HistogramSnapshot getSnapshot() const;
+    // Not thread safe against concurrent record calls
+    void reset();
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::NUM_BUCKETS> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+};
+
+} // namespace anira
+
+#endif //ANIRA_ATOMICHISTOGRAM_H
@@ -3,7 +3,11 @@
 
 #include <iostream>
 #include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
 #include "anira/system/AniraConfig.h"
+#include "MemoryAllocator.h"
 
 namespace anira {
 
@@ -36,11 +40,10 @@ public:
         } else {
             // we allocate memory for the pointers to the channels but we do not allocate memory for the data itself
             // if we would directly reference the data with m_p_channels = data, then when we would delete the buffer, the data pointers would be deleted as well
-            m_p_channels = new T*[m_number_of_channels];
+            allocateMemory(false);
             for (size_t i = 0; i < m_number_of_channels; i++) {
                 m_p_channels[i] = data[i];
             }
-            m_p_data = nullptr; // since we cannot garantee that the data will be in a contiguous block of memory when we reference it from blocks of memory
         }
     }
 
@@ -52,32 +55,29 @@ public:
             return;
         } else {
             allocateMemory();
-            std::memcpy(m_p_data, other.m_p_data, m_number_of_channels * m_size * sizeof(T));
+            copyChannelsFrom(other);
         }
     }
 
     // Move constructor takes an rvalue reference to another buffer and moves the data from the other buffer to the new buffer, then the other buffer is left in a valid but null state
     // marked as noexcept since it is not supposed to throw exceptions and if it does, the program will terminate, this is because the move constructor could corrupt the data in the other buffer if it fails
     AudioBuffer(AudioBuffer&& other) noexcept
-        : m_number_of_channels(other.m_number_of_channels), m_size(other.m_size), m_p_data(other.m_p_data), m_p_channels(other.m_p_channels)
     {
-        other.m_number_of_channels = 0;
-        other.m_size = 0;
-        other.m_p_data = nullptr;
-        other.m_p_channels = nullptr;
+        takeMemoryFrom(other);
     }
 
     ~AudioBuffer()
     {
-        delete[] m_p_data;
-        delete[] m_p_channels;
+        freeMemory();
     }
 
     // Copy assignment operator takes an lvalue reference to another buffer and copies the data from the other buffer to this buffer
     AudioBuffer& operator=(const AudioBuffer& other)
     {
-        initialize(other.m_number_of_channels, other.m_size);
-        std::memcpy(m_p_data, other.m_p_data, m_number_of_channels * m_size * sizeof(T));
+        if (this != &other) {
+            initialize(other.m_number_of_channels, other.m_size);
+            copyChannelsFrom(other);
+        }
         return *this;
     }
 
@@ -86,16 +86,8 @@ public:
     AudioBuffer& operator=(AudioBuffer&& other) noexcept
     {
         if (this != &other) {
-            delete[] m_p_data;
-            delete[] m_p_channels;
-            m_number_of_channels = other.m_number_of_channels;
-            m_size = other.m_size;
-            m_p_data = other.m_p_data;
-            m_p_channels = other.m_p_channels;
-            other.m_number_of_channels = 0;
-            other.m_size = 0;
-            other.m_p_data = nullptr;
-            other.m_p_channels = nullptr;
+            freeMemory();
+            takeMemoryFrom(other);
         }
         return *this;
     }
@@ -103,8 +95,7 @@ public:
     // Resets the buffer to the given number of channels and samples and either copies the data from the given blocks of memory to the internal buffer data or reference the data from the given blocks of memory
     void resetFromData(T* const* data, size_t number_of_channels, size_t size, bool copy_data = true)
     {
-        delete[] m_p_data;
-        delete[] m_p_channels;
+        freeMemory();
         m_number_of_channels = number_of_channels;
         m_size = size;
         if (copy_data) {
@@ -114,24 +105,39 @@ public:
             }
         } else {
             // we allocate memory for the pointers to the channels but we do not allocate memory for the data itself see the respective constructor for more details
-            m_p_channels = new T*[m_number_of_channels];
+            allocateMemory(false);
             for (size_t i = 0; i < m_number_of_channels; i++) {
                 m_p_channels[i] = data[i];
             }
-            m_p_data = nullptr; // since we cannot garantee that the data will be in a contiguous block of memory when we reference it from blocks of memory
         }
     }
 
     // Resizes the buffer to the given number of channels and samples, all data in the buffer is lost    
     void initialize(size_t number_of_channels, size_t size)
     {
-        delete[] m_p_data;
-        delete[] m_p_channels;
+        freeMemory();
         m_number_of_channels = number_of_channels;
         m_size = size;
         allocateMemory();
     }
 
+    // Sets the allocator that is used for all following allocations, the allocator must outlive the memory it hands out to this buffer
+    void setAllocator(MemoryAllocator& allocator)
+    {
+        m_p_allocator = &allocator;
+    }
+
+    MemoryAllocator& getAllocator() const
+    {
+        return *m_p_allocator;
+    }
+
+    // Returns the number of bytes a buffer with the given number of channels and samples requests from its allocator (including the alignment padding)
+    static size_t getRequiredMemory(size_t number_of_channels, size_t size)
+    {
+        return alignUp(getDataOffset(number_of_channels) + number_of_channels * size * sizeof(T), MEMORY_ALIGNMENT);
+    }
+
     // Returns the number of channels in the buffer, const since it is not supposed to modify any member variables
     size_t getNumChannels() const
     {
@@ -205,8 +211,12 @@ public:
     // Clears the buffer by setting all samples to 0
     void clear()
     {
-        for (size_t i = 0; i < m_number_of_channels * m_size; i++) {
-            m_p_data[i] = 0;
+        if (m_p_data != nullptr) {
+            clearSamples(m_p_data, m_number_of_channels * m_size);
+        } else {
+            for (size_t i = 0; i < m_number_of_channels; i++) {
+                clearSamples(m_p_channels[i], m_size);
+            }
         }
     }
 
@@ -228,17 +238,82 @@ public:
 
 private:
 
-    void allocateMemory()
+    // The channel pointers are stored at the beginning of the same block as the samples, the samples start at the next aligned address
+    static size_t getDataOffset(size_t number_of_channels)
+    {
+        return alignUp(number_of_channels * sizeof(T*), MEMORY_ALIGNMENT);
+    }
+
+    // Allocates one aligned block for the channel pointers and, if with_data is set, the samples of all channels in one contiguous block
+    void allocateMemory(bool with_data = true)
+    {
+        m_p_data = nullptr;
+        m_p_channels = nullptr;
+        m_block_size = with_data ? getRequiredMemory(m_number_of_channels, m_size) : getDataOffset(m_number_of_channels);
+        if (m_block_size == 0) {
+            return;
+        }
+        m_p_block = static_cast<std::byte*>(m_p_allocator->allocate(m_block_size, MEMORY_ALIGNMENT));
+        m_p_channels = reinterpret_cast<T**>(m_p_block);
+        if (with_data) {
+            m_p_data = reinterpret_cast<T*>(m_p_block + getDataOffset(m_number_of_channels));
+            for (size_t i = 0; i < m_number_of_channels; i++) {
+                m_p_channels[i] = m_p_data + i * m_size;
+            }
+        }
+    }
+
+    void freeMemory()
+    {
+        if (m_p_block != nullptr) {
+            m_p_allocator->deallocate(m_p_block, m_block_size, MEMORY_ALIGNMENT);
+        }
+        m_p_block = nullptr;
+        m_block_size = 0;
+        m_p_channels = nullptr;
+        m_p_data = nullptr;
+    }
+
+    // Takes over the memory and the allocator of the other buffer and leaves the other buffer in a valid but null state
+    void takeMemoryFrom(AudioBuffer& other) noexcept
+    {
+        m_number_of_channels = other.m_number_of_channels;
+        m_size = other.m_size;
+        m_p_allocator = other.m_p_allocator;
+        m_p_block = other.m_p_block;
+        m_block_size = other.m_block_size;
+        m_p_channels = other.m_p_channels;
+        m_p_data = other.m_p_data;
+        other.m_number_of_channels = 0;
+        other.m_size = 0;
+        other.m_p_block = nullptr;
+        other.m_block_size = 0;
+        other.m_p_channels = nullptr;
+        other.m_p_data = nullptr;
+    }
+
+    // Works channel by channel, since the other buffer might reference its data from non contiguous blocks of memory
+    void copyChannelsFrom(const AudioBuffer& other)
     {
-        m_p_data = new T[m_number_of_channels * m_size];
-        m_p_channels = new T*[m_number_of_channels];
         for (size_t i = 0; i < m_number_of_channels; i++) {
-            m_p_channels[i] = m_p_data + i * m_size;
+            std::memcpy(m_p_channels[i], other.m_p_channels[i], m_size * sizeof(T));
+        }
+    }
+
+    static void clearSamples(T* data, size_t num_samples)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memset(data, 0, num_samples * sizeof(T));
+        } else {
+            std::fill(data, data + num_samples, T(0));
         }
     }
 
     size_t m_number_of_channels = 0;
     size_t m_size = 0;
+    MemoryAllocator* m_p_allocator = &MemoryAllocator::getDefault();
+    std::byte* m_p_block = nullptr;
+    size_t m_block_size = 0;
     T** m_p_channels = nullptr;
     T* m_p_data = nullptr;
 };
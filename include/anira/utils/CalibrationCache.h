@@ -0,0 +1,33 @@
+#ifndef ANIRA_CALIBRATIONCACHE_H
+#define ANIRA_CALIBRATIONCACHE_H
+
+#include <map>
+#include <string>
+#include "InferenceBackend.h"
+#include "../InferenceConfig.h"
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Calibrated max inference times stored in a text file, one "key<TAB>time in ms" entry per line.
+// The key identifies the model file (path, size and modification time), the backend, the model sizes, the percentile and the cpu, so a result is only reused on the same machine for the same model.
+class ANIRA_API CalibrationCache {
+public:
+    // Reads the file if it exists
+    CalibrationCache(const std::string& path);
+
+    bool get(const std::string& key, float& maxInferenceTime) const;
+    // Adds or replaces the entry and rewrites the file, returns false if the file could not be written
+    bool set(const std::string& key, float maxInferenceTime);
+
+    static std::string getKey(const InferenceConfig& config, InferenceBackend backend);
+    static std::string getCpuName();
+
+private:
+    std::string m_path;
+    std::map<std::string, float> m_entries;
+};
+
+} // namespace anira
+
+#endif //ANIRA_CALIBRATIONCACHE_H
@@ -9,9 +9,11 @@ struct ANIRA_API HostAudioConfig {
     size_t hostChannels;
     size_t hostBufferSize;
     double hostSampleRate;
+    // If set, process() accepts any number of samples up to hostBufferSize and the latency covers the worst case of all block sizes
+    bool variableBufferSize = false;
 
     bool operator==(const HostAudioConfig& other) const {
-        return hostChannels == other.hostChannels && hostBufferSize == other.hostBufferSize && hostSampleRate == other.hostSampleRate;
+        return hostChannels == other.hostChannels && hostBufferSize == other.hostBufferSize && hostSampleRate == other.hostSampleRate && variableBufferSize == other.variableBufferSize;
     }
 
     bool operator!=(const HostAudioConfig& other) const {
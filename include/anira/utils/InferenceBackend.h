@@ -16,6 +16,26 @@ enum InferenceBackend {
     NONE
 };
 
+constexpr const char* getInferenceBackendName(InferenceBackend backend) {
+    switch (backend) {
+#ifdef USE_LIBTORCH
+        case LIBTORCH:
+            return "libtorch";
+#endif
+#ifdef USE_ONNXRUNTIME
+        case ONNX:
+            return "onnx";
+#endif
+#ifdef USE_TFLITE
+        case TFLITE:
+            return "tflite";
+#endif
+        case NONE:
+            return "none";
+    }
+    return "unknown";
+}
+
 } // namespace anira
 
 #endif //ANIRA_INFERENCEBACKEND_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef ANIRA_MAPPEDFILE_H
+#define ANIRA_MAPPEDFILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Read-only, shared memory mapping of a model file. Within a process every file is mapped once and shared by all backends that use it,
+// across processes the page cache holds the pages once, so many instances of a model keep a single copy of the file in physical memory.
+class ANIRA_API MappedFile {
+public:
+    // Returns the mapping of the file and maps it if no one else holds it. With hugePages the kernel is asked to back the mapping with
+    // transparent huge pages (Linux only, needs CONFIG_READ_ONLY_THP_FOR_FS for file mappings), otherwise it is ignored. Throws std::runtime_error if the file can not be mapped.
+    static std::shared_ptr<const MappedFile> open(const std::string& path, bool hugePages = false);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const void* getData() const { return m_data; }
+    size_t getSize() const { return m_size; }
+
+private:
+    MappedFile(const std::string& path, bool hugePages);
+
+    const void* m_data = nullptr;
+    size_t m_size = 0;
+#if WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+} // namespace anira
+
+#endif //ANIRA_MAPPEDFILE_H
@@ -0,0 +1,37 @@
+#ifndef ANIRA_MEMORYALLOCATOR_H
+#define ANIRA_MEMORYALLOCATOR_H
+
+#include <cstddef>
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Alignment of all audio data allocated by anira, 64 bytes cover a cache line and a full AVX-512 register
+constexpr size_t MEMORY_ALIGNMENT = 64;
+
+// Rounds the given size up to the next multiple of the given alignment (alignment must be a power of two)
+constexpr size_t alignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+// Interface for the memory that backs the anira::AudioBuffer instances, so that buffers can live in a custom memory region (e.g. a per-session anira::MemoryArena)
+class ANIRA_API MemoryAllocator {
+public:
+    virtual ~MemoryAllocator() = default;
+
+    virtual void* allocate(size_t size, size_t alignment) = 0;
+    virtual void deallocate(void* ptr, size_t size, size_t alignment) = 0;
+
+    // Returns the process-wide allocator that uses the global aligned operator new
+    static MemoryAllocator& getDefault();
+};
+
+class ANIRA_API DefaultAllocator : public MemoryAllocator {
+public:
+    void* allocate(size_t size, size_t alignment) override;
+    void deallocate(void* ptr, size_t size, size_t alignment) override;
+};
+
+} // namespace anira
+
+#endif //ANIRA_MEMORYALLOCATOR_H
@@ -0,0 +1,50 @@
+#ifndef ANIRA_MEMORYARENA_H
+#define ANIRA_MEMORYARENA_H
+
+#include <cstddef>
+#include "MemoryAllocator.h"
+
+namespace anira {
+
+// A bump allocator over one contiguous, prefaulted memory region. Allocations are never freed individually, the whole region is rewound with reset().
+// When the region is exhausted, allocations fall back to the default allocator, so an undersized arena is slower but never fails.
+class ANIRA_API MemoryArena : public MemoryAllocator {
+public:
+    MemoryArena();
+    ~MemoryArena() override;
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    // Makes sure the region holds at least capacity bytes, unlocks and rewinds it, all previous allocations become invalid. Not real-time safe.
+    void reserve(size_t capacity);
+    // Rewinds the region without touching the memory
+    void reset();
+    // Frees the region
+    void release();
+
+    void* allocate(size_t size, size_t alignment) override;
+    void deallocate(void* ptr, size_t size, size_t alignment) override;
+
+    // Locks the pages allocated so far in physical memory so they are never paged out, returns false if the operating system refused.
+    // Call it after the allocations, later ones are not covered.
+    bool lock();
+    void unlock();
+    bool isLocked() const;
+
+    size_t getCapacity() const;
+    size_t getUsedBytes() const;
+
+private:
+    bool owns(const void* ptr) const;
+
+    std::byte* m_p_region = nullptr;
+    size_t m_capacity = 0;
+    size_t m_offset = 0;
+    size_t m_locked_size = 0;
+    bool m_locked = false;
+};
+
+} // namespace anira
+
+#endif //ANIRA_MEMORYARENA_H
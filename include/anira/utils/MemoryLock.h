@@ -0,0 +1,21 @@
+#ifndef ANIRA_MEMORYLOCK_H
+#define ANIRA_MEMORYLOCK_H
+
+#include <cstddef>
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Keeps memory in physical ram (mlock, VirtualLock), locking also faults the pages in. Returns false if the operating system refused, usually because of RLIMIT_MEMLOCK.
+ANIRA_API bool lockMemory(const void* ptr, size_t size);
+ANIRA_API void unlockMemory(const void* ptr, size_t size);
+// Linux only: locks all current and future pages of the process (mlockall with MCL_CURRENT | MCL_FUTURE)
+ANIRA_API bool lockAllMemory();
+// The number of bytes a process may lock (RLIMIT_MEMLOCK), SIZE_MAX if there is no limit or it is unknown
+ANIRA_API size_t getMemoryLockLimit();
+// Prints a warning with the limit and how to raise it, what tells which memory could not be locked and size may be 0 if unknown
+ANIRA_API void reportMemoryLockFailure(const char* what, size_t size);
+
+} // namespace anira
+
+#endif //ANIRA_MEMORYLOCK_H
@@ -18,6 +18,20 @@ public:
     float popSample(size_t channel);
     float getSampleFromTail(size_t channel, size_t offset);
     size_t getAvailableSamples(size_t channel);
+    // Smallest number of available samples over all channels
+    size_t getMinAvailableSamples();
+
+    // Block variants of the methods above, the wrap-around splits each call into at most two vectorized copies
+    void pushSamples(size_t channel, const float* samples, size_t numSamples);
+    void popSamples(size_t channel, float* samples, size_t numSamples);
+    // Copies numSamples samples starting offset samples before the read position without moving it
+    void getSamplesFromTail(size_t channel, size_t offset, float* samples, size_t numSamples);
+    // Returns a pointer to numSamples samples starting offset samples before the read position, or nullptr if they wrap around the end of the buffer
+    const float* getContiguousTail(size_t channel, size_t offset, size_t numSamples) const;
+    // Moves the read position forward without copying the samples
+    void discardSamples(size_t channel, size_t numSamples);
+    // Largest magnitude of the next numSamples samples, the read position stays
+    float getPeak(size_t channel, size_t numSamples) const;
 
 private:
     std::vector<size_t> readPos, writePos;
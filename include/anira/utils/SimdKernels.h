@@ -0,0 +1,80 @@
+#ifndef ANIRA_SIMDKERNELS_H
+#define ANIRA_SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+namespace simd {
+
+enum class InstructionSet {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+// One implementation of every sample-moving kernel. Source and destination must not overlap, none of the pointers needs to be aligned.
+struct ANIRA_API KernelTable {
+    InstructionSet instructionSet;
+    void (*copy)(float* dst, const float* src, size_t numSamples);
+    void (*fill)(float* dst, float value, size_t numSamples);
+    // dst[i] = src[i] * gain
+    void (*copyWithGain)(float* dst, const float* src, float gain, size_t numSamples);
+    // dst[i] += src[i] * gain
+    void (*addWithGain)(float* dst, const float* src, float gain, size_t numSamples);
+    void (*interleave)(float* dst, const float* const* src, size_t numChannels, size_t numSamples);
+    void (*deinterleave)(float* const* dst, const float* src, size_t numChannels, size_t numSamples);
+    void (*int16ToFloat)(float* dst, const int16_t* src, size_t numSamples);
+    // Clamps to [-1, 1], scales by 32767 and rounds to nearest
+    void (*floatToInt16)(int16_t* dst, const float* src, size_t numSamples);
+};
+
+// Returns the kernels for the best instruction set that the cpu supports. The choice is made once at the first call and can be overwritten with the environment variable ANIRA_SIMD (scalar, sse2, avx2, avx512 or neon).
+ANIRA_API const KernelTable& getKernels();
+// Returns the kernels for the given instruction set or nullptr if the instruction set was not compiled in or is not supported by the cpu
+ANIRA_API const KernelTable* getKernels(InstructionSet instructionSet);
+ANIRA_API const char* getInstructionSetName(InstructionSet instructionSet);
+
+inline void copy(float* dst, const float* src, size_t numSamples) {
+    getKernels().copy(dst, src, numSamples);
+}
+
+inline void fill(float* dst, float value, size_t numSamples) {
+    getKernels().fill(dst, value, numSamples);
+}
+
+inline void clear(float* dst, size_t numSamples) {
+    getKernels().fill(dst, 0.f, numSamples);
+}
+
+inline void copyWithGain(float* dst, const float* src, float gain, size_t numSamples) {
+    getKernels().copyWithGain(dst, src, gain, numSamples);
+}
+
+inline void addWithGain(float* dst, const float* src, float gain, size_t numSamples) {
+    getKernels().addWithGain(dst, src, gain, numSamples);
+}
+
+inline void interleave(float* dst, const float* const* src, size_t numChannels, size_t numSamples) {
+    getKernels().interleave(dst, src, numChannels, numSamples);
+}
+
+inline void deinterleave(float* const* dst, const float* src, size_t numChannels, size_t numSamples) {
+    getKernels().deinterleave(dst, src, numChannels, numSamples);
+}
+
+inline void int16ToFloat(float* dst, const int16_t* src, size_t numSamples) {
+    getKernels().int16ToFloat(dst, src, numSamples);
+}
+
+inline void floatToInt16(int16_t* dst, const float* src, size_t numSamples) {
+    getKernels().floatToInt16(dst, src, numSamples);
+}
+
+} // namespace simd
+} // namespace anira
+
+#endif //ANIRA_SIMDKERNELS_H
@@ -0,0 +1,76 @@
+#ifndef ANIRA_TELEMETRYEVENT_H
+#define ANIRA_TELEMETRYEVENT_H
+
+#include <cstdint>
+#include "anira/system/AniraConfig.h"
+
+// 0 strips all telemetry, 1 keeps the warnings, 2 also keeps the informational events. Set with the CMake cache variable ANIRA_TELEMETRY_LEVEL.
+#ifndef ANIRA_TELEMETRY_LEVEL
+#define ANIRA_TELEMETRY_LEVEL 2
+#endif
+
+namespace anira {
+
+enum class TelemetryEventType {
+    MissingSamples, // value: number of samples that were replaced by silence
+    CatchUpSamples, // value: number of samples that were dropped to catch up
+    QueueFull, // value: number of samples that were not processed because no inference slot was free
+    BackendSwitch, // value: the new InferenceBackend
+    LatencyChange, // value: the new latency in samples
+    Fallback, // value: the InferenceBackend the session fell back to
+    Recovery // value: the InferenceBackend the session returned to
+};
+
+enum TelemetryLevel {
+    TELEMETRY_OFF = 0,
+    TELEMETRY_WARNING = 1,
+    TELEMETRY_INFO = 2
+};
+
+struct ANIRA_API TelemetryEvent {
+    TelemetryEventType type;
+    int sessionID;
+    // Nanoseconds on the std::chrono::steady_clock
+    int64_t timeStamp;
+    int64_t value;
+};
+
+constexpr TelemetryLevel getTelemetryLevel(TelemetryEventType type) {
+    switch (type) {
+        case TelemetryEventType::BackendSwitch:
+        case TelemetryEventType::LatencyChange:
+        case TelemetryEventType::Recovery:
+            return TELEMETRY_INFO;
+        default:
+            return TELEMETRY_WARNING;
+    }
+}
+
+// Events above the compiled telemetry level are removed at compile time
+constexpr bool isTelemetryEnabled(TelemetryEventType type) {
+    return getTelemetryLevel(type) <= ANIRA_TELEMETRY_LEVEL;
+}
+
+constexpr const char* getTelemetryEventName(TelemetryEventType type) {
+    switch (type) {
+        case TelemetryEventType::MissingSamples:
+            return "Missing samples";
+        case TelemetryEventType::CatchUpSamples:
+            return "Catch up samples";
+        case TelemetryEventType::QueueFull:
+            return "No free inferenceQueue found";
+        case TelemetryEventType::BackendSwitch:
+            return "Backend switch";
+        case TelemetryEventType::LatencyChange:
+            return "Latency change";
+        case TelemetryEventType::Fallback:
+            return "Overload, falling back to a cheaper backend";
+        case TelemetryEventType::Recovery:
+            return "Recovered from overload";
+    }
+    return "Unknown event";
+}
+
+} // namespace anira
+
+#endif //ANIRA_TELEMETRYEVENT_H
@@ -0,0 +1,52 @@
+#ifndef ANIRA_TELEMETRYRING_H
+#define ANIRA_TELEMETRYRING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include "TelemetryEvent.h"
+
+namespace anira {
+
+// Bounded lock-free multi-producer multi-consumer queue of telemetry events (Dmitry Vyukov's design). All memory is allocated in the constructor, so pushing from the audio thread never allocates, locks or blocks. When the ring is full, new events are dropped and counted.
+class ANIRA_API TelemetryRing {
+public:
+    // The capacity is rounded up to the next power of two
+    TelemetryRing(size_t capacity = 1024);
+
+    TelemetryRing(const TelemetryRing&) = delete;
+    TelemetryRing& operator=(const TelemetryRing&) = delete;
+
+    bool push(const TelemetryEvent& event);
+    bool pop(TelemetryEvent& event);
+
+    // Records an event with the current time, compiles to nothing if the event type is above ANIRA_TELEMETRY_LEVEL
+    template <TelemetryEventType Type>
+    void record(int sessionID, int64_t value) {
+        if constexpr (isTelemetryEnabled(Type)) {
+            int64_t time_stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            push({Type, sessionID, time_stamp, value});
+        }
+    }
+
+    size_t getCapacity() const;
+    size_t getNumDroppedEvents() const;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        TelemetryEvent event;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    // Producers and consumers work on different cache lines
+    alignas(64) std::atomic<size_t> m_enqueue_pos {0};
+    alignas(64) std::atomic<size_t> m_dequeue_pos {0};
+    alignas(64) std::atomic<size_t> m_dropped_events {0};
+};
+
+} // namespace anira
+
+#endif //ANIRA_TELEMETRYRING_H
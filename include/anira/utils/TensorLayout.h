@@ -0,0 +1,163 @@
+#ifndef ANIRA_TENSORLAYOUT_H
+#define ANIRA_TENSORLAYOUT_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "RingBuffer.h"
+#include "WindowLayout.h"
+#include "InferenceBackend.h"
+#include "SimdKernels.h"
+
+namespace anira {
+
+enum class TensorAxis {
+    Batch,
+    Channel,
+    Time
+};
+
+// Marks a size of a TensorLayout that is only known at runtime
+constexpr size_t DYNAMIC_SIZE = 0;
+
+// The roles of the axes of a model input tensor in their order, e.g. TensorAxes<TensorAxis::Batch, TensorAxis::Channel, TensorAxis::Time> for [batch, channel, time]
+template <TensorAxis... Axes>
+struct TensorAxes {
+    static constexpr size_t rank = sizeof...(Axes);
+    static constexpr std::array<TensorAxis, rank> axes = {Axes...};
+
+    // Returns the index of the axis or rank if the tensor has no such axis
+    static constexpr size_t indexOf(TensorAxis axis) {
+        for (size_t i = 0; i < rank; ++i) {
+            if (axes[i] == axis) return i;
+        }
+        return rank;
+    }
+
+    static constexpr bool has(TensorAxis axis) {
+        return indexOf(axis) < rank;
+    }
+
+    static constexpr WindowLayout::ChannelPlacement channelPlacement() {
+        if (!has(TensorAxis::Channel)) return WindowLayout::ChannelsFirst;
+        if (indexOf(TensorAxis::Channel) > indexOf(TensorAxis::Time)) return WindowLayout::ChannelsLast;
+        if (has(TensorAxis::Batch) && indexOf(TensorAxis::Channel) > indexOf(TensorAxis::Batch)) return WindowLayout::ChannelsBeforeWindow;
+        return WindowLayout::ChannelsFirst;
+    }
+};
+
+// Compile-time description of a windowed model input. Sizes that are known at compile time are baked into the window extraction, so the loops over them have a fixed trip count that the compiler can unroll and vectorize. The other sizes are resolved once from the model shape.
+template <typename Axes, size_t WindowSize, size_t HopSize = DYNAMIC_SIZE, size_t NumBatches = DYNAMIC_SIZE, size_t NumChannels = 1>
+struct TensorLayout {
+    static_assert(Axes::has(TensorAxis::Time), "A tensor layout needs a time axis");
+    static_assert(NumChannels == 1 || NumChannels == DYNAMIC_SIZE || Axes::has(TensorAxis::Channel), "A tensor layout with several channels needs a channel axis");
+
+    static constexpr size_t rank = Axes::rank;
+    static constexpr size_t windowSize = WindowSize;
+    static constexpr size_t hopSize = HopSize;
+    static constexpr size_t numBatches = NumBatches;
+    static constexpr size_t numChannels = NumChannels;
+    static constexpr WindowLayout::ChannelPlacement channelPlacement = Axes::channelPlacement();
+
+    // Checks the static sizes against the model shape and resolves the dynamic ones, the hop size follows from the number of new samples per inference. Not real-time safe.
+    static WindowLayout resolve(const std::vector<int64_t>& shape, size_t numNewSamples) {
+        if (shape.size() != rank) {
+            throw std::runtime_error("The rank of the model shape does not match the tensor layout");
+        }
+        WindowLayout layout {(size_t) shape[Axes::indexOf(TensorAxis::Time)]};
+        layout.numBatches = Axes::has(TensorAxis::Batch) ? (size_t) shape[Axes::indexOf(TensorAxis::Batch)] : 1;
+        layout.numChannels = Axes::has(TensorAxis::Channel) ? (size_t) shape[Axes::indexOf(TensorAxis::Channel)] : 1;
+        layout.hopSize = numNewSamples / layout.numBatches;
+        layout.channelPlacement = channelPlacement;
+
+        if ((WindowSize != DYNAMIC_SIZE && WindowSize != layout.windowSize) ||
+            (HopSize != DYNAMIC_SIZE && HopSize != layout.hopSize) ||
+            (NumBatches != DYNAMIC_SIZE && NumBatches != layout.numBatches) ||
+            (NumChannels != DYNAMIC_SIZE && NumChannels != layout.numChannels) ||
+            layout.hopSize * layout.numBatches != numNewSamples) {
+            throw std::runtime_error("The model shape does not match the static sizes of the tensor layout");
+        }
+        return layout;
+    }
+
+    // Same result as PrePostProcessor::popWindowsFromBuffer, with the static sizes as constants
+    static void popWindows(RingBuffer& input, AudioBufferF& output, const WindowLayout& layout) {
+        const size_t window_size = WindowSize != DYNAMIC_SIZE ? WindowSize : layout.windowSize;
+        const size_t hop_size = HopSize != DYNAMIC_SIZE ? HopSize : layout.hopSize;
+        const size_t num_batches = NumBatches != DYNAMIC_SIZE ? NumBatches : layout.numBatches;
+        const size_t num_channels = NumChannels != DYNAMIC_SIZE ? NumChannels : layout.numChannels;
+
+        for (size_t channel = 0; channel < num_channels; ++channel) {
+            input.discardSamples(channel, hop_size * num_batches);
+
+            for (size_t batch = 0; batch < num_batches; ++batch) {
+                size_t offset_from_tail = window_size + (num_batches - 1 - batch) * hop_size;
+                float* window = output.getWritePointer(0, getWindowOffset(channel, batch, window_size, num_batches, num_channels));
+
+                if (channelPlacement != WindowLayout::ChannelsLast || num_channels == 1) {
+                    const float* source = input.getContiguousTail(channel, offset_from_tail, window_size);
+                    if (source != nullptr) {
+                        copyWindow(window, source, window_size);
+                    } else {
+                        input.getSamplesFromTail(channel, offset_from_tail, window, window_size);
+                    }
+                } else {
+                    for (size_t i = 0; i < window_size; ++i) {
+                        window[i * num_channels] = input.getSampleFromTail(channel, offset_from_tail - i);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static size_t getWindowOffset(size_t channel, size_t batch, size_t window_size, size_t num_batches, size_t num_channels) {
+        if constexpr (channelPlacement == WindowLayout::ChannelsFirst) {
+            return (channel * num_batches + batch) * window_size;
+        } else if constexpr (channelPlacement == WindowLayout::ChannelsBeforeWindow) {
+            return (batch * num_channels + channel) * window_size;
+        } else {
+            return batch * window_size * num_channels + channel;
+        }
+    }
+
+    static void copyWindow(float* destination, const float* source, size_t window_size) {
+        if constexpr (WindowSize != DYNAMIC_SIZE) {
+            for (size_t i = 0; i < WindowSize; ++i) {
+                destination[i] = source[i];
+            }
+        } else {
+            simd::copy(destination, source, window_size);
+        }
+    }
+};
+
+// Holds one TensorLayout instantiation per backend, so that the pre-processing finds the layout of the current backend with one table lookup instead of branching on the backend and reading the shape vectors on every inference
+class WindowExtractor {
+public:
+    using Function = void (*)(RingBuffer& input, AudioBufferF& output, const WindowLayout& layout);
+
+    // Resolves the layout against the model shape of the backend, call it from PrePostProcessor::prepare for every backend that can be selected
+    template <typename Layout>
+    void setLayout(InferenceBackend backend, const std::vector<int64_t>& shape, size_t numNewSamples) {
+        m_layouts[backend] = Layout::resolve(shape, numNewSamples);
+        m_functions[backend] = &Layout::popWindows;
+    }
+
+    void popWindows(InferenceBackend backend, RingBuffer& input, AudioBufferF& output) const {
+        m_functions[backend](input, output, m_layouts[backend]);
+    }
+
+    const WindowLayout& getLayout(InferenceBackend backend) const {
+        return m_layouts[backend];
+    }
+
+private:
+    std::array<Function, NONE + 1> m_functions {};
+    std::array<WindowLayout, NONE + 1> m_layouts {};
+};
+
+} // namespace anira
+
+#endif //ANIRA_TENSORLAYOUT_H
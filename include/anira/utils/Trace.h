@@ -0,0 +1,111 @@
+#ifndef ANIRA_TRACE_H
+#define ANIRA_TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "anira/system/AniraConfig.h"
+
+// The trace points on the hot path only exist when the library is built with the CMake option ANIRA_WITH_TRACING, otherwise they compile to nothing
+#ifdef ANIRA_TRACING
+#define ANIRA_TRACE(type, sessionID, slotID) ::anira::Tracer::record(::anira::TraceEventType::type, sessionID, slotID)
+#else
+#define ANIRA_TRACE(type, sessionID, slotID) ((void) 0)
+#endif
+
+namespace anira {
+
+// The stages one inference slot passes through, in order
+enum class TraceEventType : uint8_t {
+    PreProcessBegin, // audio thread
+    Submit, // audio thread, the slot is ready for the workers
+    Dequeue, // inference thread, the slot was picked up
+    InferenceBegin, // inference thread
+    InferenceEnd, // inference thread
+    Done, // inference thread, the output is ready
+    PostProcessBegin, // audio thread
+    Collect // audio thread, the slot is free again
+};
+
+struct ANIRA_API TraceEvent {
+    // Nanoseconds on the std::chrono::steady_clock
+    int64_t timeStamp;
+    int sessionID;
+    // The timeStamp of the inference slot, identifies one block on its way through the pipeline
+    unsigned int slotID;
+    TraceEventType type;
+};
+
+ANIRA_API const char* getTraceEventName(TraceEventType type);
+
+// Fixed-size buffer of trace events that is written by exactly one thread. Recording never allocates, locks or blocks. When the buffer is full, new events are dropped and counted.
+class ANIRA_API TraceBuffer {
+public:
+    TraceBuffer(size_t capacity, size_t index);
+
+    TraceBuffer(const TraceBuffer&) = delete;
+    TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+    // Must only be called from the thread that owns the buffer
+    void record(TraceEventType type, int sessionID, unsigned int slotID);
+
+    // The events [0, getNumEvents()) can be read while the owning thread keeps recording
+    size_t getNumEvents() const;
+    const TraceEvent& getEvent(size_t index) const;
+    size_t getNumDroppedEvents() const;
+    size_t getIndex() const;
+
+    // The owning thread rewinds the buffer before its next event, until then the buffer appears empty
+    void requestClear();
+
+private:
+    friend class Tracer;
+
+    std::unique_ptr<TraceEvent[]> m_events;
+    size_t m_capacity;
+    size_t m_index;
+    std::atomic<size_t> m_size {0};
+    std::atomic<size_t> m_dropped_events {0};
+    std::atomic<bool> m_clear_requested {false};
+    // False once the owning thread has exited, the buffer is then handed to the next thread that starts recording
+    std::atomic<bool> m_in_use {false};
+};
+
+// Registry of the per-thread trace buffers and exporter to the Chrome trace event format, which can be opened in Perfetto or chrome://tracing.
+// All functions except record must be called from non real-time threads and not concurrently with each other.
+class ANIRA_API Tracer {
+public:
+    static constexpr bool isEnabled() {
+#ifdef ANIRA_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Records an event into the buffer of the calling thread. The first event of a thread allocates its buffer, call registerThread beforehand to keep this off real-time threads.
+    static void record(TraceEventType type, int sessionID, unsigned int slotID);
+    static void registerThread();
+    // Hands the buffer of the calling thread, including its events, to the next thread that registers. Called automatically when a thread exits.
+    static void unregisterThread();
+
+    // Number of events each newly allocated thread buffer can hold
+    static void setBufferCapacity(size_t capacity);
+    static size_t getBufferCapacity();
+
+    // Discards all recorded events
+    static void clear();
+    static size_t getNumEvents();
+    static size_t getNumDroppedEvents();
+
+    static void writeChromeTrace(std::ostream& stream);
+    // Returns false if the file could not be opened
+    static bool writeChromeTrace(const std::string& path);
+};
+
+} // namespace anira
+
+#endif //ANIRA_TRACE_H
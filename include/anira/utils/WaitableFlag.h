@@ -0,0 +1,40 @@
+#ifndef ANIRA_WAITABLEFLAG_H
+#define ANIRA_WAITABLEFLAG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Lock-free flag with one producer that sets it and one consumer that resets it, the atomic counterpart of a binary semaphore.
+// The consumer can wait for the flag with a deadline. On Linux (futex) and Windows (WaitOnAddress) it sleeps in the kernel until the flag is set or the deadline has passed, on other platforms it polls.
+// The producer only makes a system call when the consumer is actually waiting.
+class ANIRA_API WaitableFlag {
+public:
+    // Producer side
+    void set();
+
+    // Consumer side, all of them reset the flag if they return true
+    bool tryConsume();
+    bool consumeUntil(std::chrono::steady_clock::time_point deadline);
+    void consume();
+
+private:
+    enum State : uint32_t {
+        Unset = 0,
+        Set = 1,
+        Waiting = 2
+    };
+
+    // 32 bit, because futexes and WaitOnAddress need an aligned word
+    std::atomic<uint32_t> m_state {Unset};
+
+    bool waitForState(std::chrono::steady_clock::time_point deadline);
+    void wakeConsumer();
+};
+
+} // namespace anira
+
+#endif //ANIRA_WAITABLEFLAG_H
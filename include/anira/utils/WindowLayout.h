@@ -0,0 +1,62 @@
+#ifndef ANIRA_WINDOWLAYOUT_H
+#define ANIRA_WINDOWLAYOUT_H
+
+#include <cstddef>
+#include "anira/system/AniraConfig.h"
+
+namespace anira {
+
+// Describes how overlapping windows of the input signal are arranged in a model input tensor, see PrePostProcessor::popWindowsFromBuffer
+struct ANIRA_API WindowLayout {
+    enum ChannelPlacement {
+        ChannelsFirst, // [channel, batch, window]
+        ChannelsBeforeWindow, // [batch, channel, window]
+        ChannelsLast // [batch, window, channel]
+    };
+
+    size_t windowSize;
+    // Distance in samples between the windows of two neighbouring batches, this is also the number of new samples each batch adds
+    size_t hopSize = 1;
+    size_t numBatches = 1;
+    size_t numChannels = 1;
+    ChannelPlacement channelPlacement = ChannelsFirst;
+
+    // Number of samples that are popped from the ring buffer per inference
+    size_t getNumNewSamples() const {
+        return hopSize * numBatches;
+    }
+
+    size_t getTensorSize() const {
+        return windowSize * numBatches * numChannels;
+    }
+
+    // Index of the first sample of the given window in the tensor
+    size_t getWindowOffset(size_t channel, size_t batch) const {
+        switch (channelPlacement) {
+            case ChannelsFirst:
+                return (channel * numBatches + batch) * windowSize;
+            case ChannelsBeforeWindow:
+                return (batch * numChannels + channel) * windowSize;
+            case ChannelsLast:
+                return batch * windowSize * numChannels + channel;
+        }
+        return 0;
+    }
+
+    // Distance in the tensor between two consecutive samples of one window
+    size_t getSampleStride() const {
+        return channelPlacement == ChannelsLast ? numChannels : 1;
+    }
+
+    bool operator==(const WindowLayout& other) const {
+        return windowSize == other.windowSize && hopSize == other.hopSize && numBatches == other.numBatches && numChannels == other.numChannels && channelPlacement == other.channelPlacement;
+    }
+
+    bool operator!=(const WindowLayout& other) const {
+        return !(*this == other);
+    }
+};
+
+} // namespace anira
+
+#endif //ANIRA_WINDOWLAYOUT_H
@@ -1,21 +1,17 @@
 #include <anira/InferenceHandler.h>
-#include <cassert>
 
 namespace anira {
 
-InferenceHandler::InferenceHandler(PrePostProcessor& ppP, InferenceConfig& config) : noneProcessor(new BackendBase(config)), inferenceManager(ppP, config, *noneProcessor) {
+InferenceHandler::InferenceHandler(PrePostProcessor& ppP, InferenceConfig& config) : defaultNoneProcessor(std::make_unique<BackendBase>(config)), noneProcessor(defaultNoneProcessor.get()), inferenceManager(ppP, config, *noneProcessor) {
 }
 
 InferenceHandler::InferenceHandler(PrePostProcessor& ppP, InferenceConfig& config, BackendBase& nP) : noneProcessor(&nP), inferenceManager(ppP, config, *noneProcessor) {
-    useCustomNoneProcessor = true;
 }
 
 InferenceHandler::~InferenceHandler() {
-    if (useCustomNoneProcessor == false) delete noneProcessor;
 }
 
 void InferenceHandler::prepare(HostAudioConfig newAudioConfig) {
-    assert(newAudioConfig.hostChannels == 1 && "Stereo processing is not fully implemented yet");
     inferenceManager.prepare(newAudioConfig);
 }
 
@@ -31,10 +27,58 @@ InferenceBackend InferenceHandler::getInferenceBackend() {
     return inferenceManager.getBackend();
 }
 
+void InferenceHandler::setOfflineMode(bool offline) {
+    inferenceManager.setOfflineMode(offline);
+}
+
+bool InferenceHandler::isOfflineMode() const {
+    return inferenceManager.isOfflineMode();
+}
+
+void InferenceHandler::setDegradationPolicy(const DegradationPolicy& policy) {
+    inferenceManager.setDegradationPolicy(policy);
+}
+
+bool InferenceHandler::isDegraded() const {
+    return inferenceManager.isDegraded();
+}
+
 int InferenceHandler::getLatency() {
     return inferenceManager.getLatency();
 }
 
+int InferenceHandler::getLatency(InferenceBackend inferenceBackend) {
+    return inferenceManager.getLatency(inferenceBackend);
+}
+
+float InferenceHandler::getMaxInferenceTime(InferenceBackend inferenceBackend) {
+    return inferenceManager.getMaxInferenceTime(inferenceBackend);
+}
+
+SessionStatisticsSnapshot InferenceHandler::getStatistics() const {
+    return inferenceManager.getStatistics();
+}
+
+std::vector<WorkerStatistics> InferenceHandler::getWorkerStatistics() const {
+    return InferenceThreadPool::getWorkerStatistics();
+}
+
+void InferenceHandler::setTelemetryListener(std::function<void(const TelemetryEvent&)> listener) {
+    inferenceManager.setTelemetryListener(std::move(listener));
+}
+
+void InferenceHandler::setLatencyListener(std::function<void(int)> listener) {
+    inferenceManager.setLatencyListener(std::move(listener));
+}
+
+void InferenceHandler::setTelemetryAutoDrain(bool autoDrain) {
+    inferenceManager.setTelemetryAutoDrain(autoDrain);
+}
+
+bool InferenceHandler::pollTelemetry(TelemetryEvent& event) {
+    return inferenceManager.pollTelemetry(event);
+}
+
 InferenceManager &InferenceHandler::getInferenceManager() {
     return inferenceManager;
 }
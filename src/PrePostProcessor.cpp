@@ -1,4 +1,5 @@
 #include <anira/PrePostProcessor.h>
+#include <anira/utils/SimdKernels.h>
 
 namespace anira {
 
@@ -9,9 +10,31 @@ void PrePostProcessor::postProcess(AudioBufferF& input, RingBuffer& output, [[ma
     pushSamplesToBuffer(input, output);
 }
 
+void PrePostProcessor::prepare([[maybe_unused]] HostAudioConfig newConfig) {
+}
+
+void PrePostProcessor::skipSamples(RingBuffer& input, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    for (size_t channel = 0; channel < input.getNumChannels(); ++channel) {
+        input.discardSamples(channel, numSamples);
+    }
+}
+
+void PrePostProcessor::preProcessChannel(RingBuffer& input, AudioBufferF& output, size_t channel, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    input.popSamples(channel, output.getWritePointer(0), output.getNumSamples());
+}
+
+void PrePostProcessor::postProcessChannel(AudioBufferF& input, RingBuffer& output, size_t channel, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    output.pushSamples(channel, input.getReadPointer(0), input.getNumSamples());
+}
+
+void PrePostProcessor::skipChannelSamples(RingBuffer& input, size_t channel, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    input.discardSamples(channel, numSamples);
+}
+
 void PrePostProcessor::popSamplesFromBuffer(RingBuffer& input, AudioBufferF& output) {
-    for (size_t j = 0; j < output.getNumSamples(); j++) {
-        output.setSample(0, j, input.popSample(0));
+    size_t num_samples = output.getNumSamples() / input.getNumChannels();
+    for (size_t channel = 0; channel < input.getNumChannels(); ++channel) {
+        input.popSamples(channel, output.getWritePointer(0, channel * num_samples), num_samples);
     }
 }
 
@@ -20,19 +43,38 @@ void PrePostProcessor::popSamplesFromBuffer(RingBuffer& input, AudioBufferF& out
 }
 
 void PrePostProcessor::popSamplesFromBuffer(RingBuffer& input, AudioBufferF& output, int numNewSamples, int numOldSamples, int offset) {
-    int numTotalSamples = numNewSamples + numOldSamples;
-    for (int j = numTotalSamples - 1; j >= 0; j--) {
-        if (j >= numOldSamples) {
-            output.setSample(0, (size_t) (numTotalSamples - j + numOldSamples - 1 + offset), input.popSample(0));
-        } else  {
-            output.setSample(0, (size_t) (j + offset), input.getSampleFromTail(0, (size_t) (numTotalSamples - j)));
+    // The old samples are the ones right before the read position, so they have to be copied before the new samples are popped
+    input.getSamplesFromTail(0, (size_t) numOldSamples, output.getWritePointer(0, (size_t) offset), (size_t) numOldSamples);
+    input.popSamples(0, output.getWritePointer(0, (size_t) (offset + numOldSamples)), (size_t) numNewSamples);
+}
+
+void PrePostProcessor::popWindowsFromBuffer(RingBuffer& input, AudioBufferF& output, const WindowLayout& layout) {
+    size_t num_new_samples = layout.getNumNewSamples();
+    size_t stride = layout.getSampleStride();
+
+    for (size_t channel = 0; channel < layout.numChannels; ++channel) {
+        // After moving the read position past the new samples, the window of batch b starts windowSize + (numBatches - 1 - b) * hopSize samples before it
+        input.discardSamples(channel, num_new_samples);
+
+        for (size_t batch = 0; batch < layout.numBatches; ++batch) {
+            size_t offset_from_tail = layout.windowSize + (layout.numBatches - 1 - batch) * layout.hopSize;
+            float* window = output.getWritePointer(0, layout.getWindowOffset(channel, batch));
+
+            if (stride == 1) {
+                input.getSamplesFromTail(channel, offset_from_tail, window, layout.windowSize);
+            } else {
+                for (size_t i = 0; i < layout.windowSize; ++i) {
+                    window[i * stride] = input.getSampleFromTail(channel, offset_from_tail - i);
+                }
+            }
         }
     }
 }
 
 void PrePostProcessor::pushSamplesToBuffer(const AudioBufferF& input, RingBuffer& output) {
-    for (size_t j = 0; j < input.getNumSamples(); j++) {
-        output.pushSample(0, input.getSample(0, j));
+    size_t num_samples = input.getNumSamples() / output.getNumChannels();
+    for (size_t channel = 0; channel < output.getNumChannels(); ++channel) {
+        output.pushSamples(channel, input.getReadPointer(0, channel * num_samples), num_samples);
     }
 }
 
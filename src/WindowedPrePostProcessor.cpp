@@ -0,0 +1,85 @@
+#include <anira/WindowedPrePostProcessor.h>
+#include <anira/utils/SimdKernels.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace anira {
+
+WindowedPrePostProcessor::WindowedPrePostProcessor(size_t windowSize, size_t numNewSamples) {
+    setWindow(windowSize, numNewSamples);
+}
+
+void WindowedPrePostProcessor::setWindow(size_t windowSize, size_t numNewSamples) {
+    if (windowSize == 0) {
+        throw std::runtime_error("The window size must not be zero");
+    }
+    m_window_size = windowSize;
+    m_num_new_samples = numNewSamples;
+}
+
+void WindowedPrePostProcessor::prepare(HostAudioConfig newConfig) {
+    if (m_window_size == 0) {
+        throw std::runtime_error("The window of the WindowedPrePostProcessor has not been set");
+    }
+    // The ring buffer is cleared when the session is prepared, so the history starts with silence as well
+    m_history.initialize(std::max<size_t>(newConfig.hostChannels, 1), 2 * m_window_size);
+    m_history.clear();
+    m_history_pos.assign(m_history.getNumChannels(), 0);
+}
+
+void WindowedPrePostProcessor::preProcess(RingBuffer& input, AudioBufferF& output, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    for (size_t channel = 0; channel < input.getNumChannels(); ++channel) {
+        pushToHistory(input, channel, m_num_new_samples);
+        copyWindow(output, channel, channel * m_window_size);
+    }
+}
+
+void WindowedPrePostProcessor::skipSamples(RingBuffer& input, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    // The skipped samples are still part of the following windows
+    for (size_t channel = 0; channel < input.getNumChannels(); ++channel) {
+        pushToHistory(input, channel, numSamples);
+    }
+}
+
+void WindowedPrePostProcessor::preProcessChannel(RingBuffer& input, AudioBufferF& output, size_t channel, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    pushToHistory(input, channel, m_num_new_samples);
+    copyWindow(output, channel, 0);
+}
+
+void WindowedPrePostProcessor::skipChannelSamples(RingBuffer& input, size_t channel, size_t numSamples, [[maybe_unused]] InferenceBackend currentInferenceBackend) {
+    pushToHistory(input, channel, numSamples);
+}
+
+size_t WindowedPrePostProcessor::getWindowSize() const {
+    return m_window_size;
+}
+
+size_t WindowedPrePostProcessor::getNumNewSamples() const {
+    return m_num_new_samples;
+}
+
+void WindowedPrePostProcessor::pushToHistory(RingBuffer& input, size_t channel, size_t numSamples) {
+    // Only the last window size samples can end up in the history
+    if (numSamples > m_window_size) {
+        input.discardSamples(channel, numSamples - m_window_size);
+        numSamples = m_window_size;
+    }
+
+    float* history = m_history.getWritePointer(channel);
+    size_t& history_pos = m_history_pos[channel];
+    size_t first = std::min(numSamples, m_window_size - history_pos);
+    size_t second = numSamples - first;
+
+    input.popSamples(channel, history + history_pos, first);
+    input.popSamples(channel, history, second);
+    simd::copy(history + m_window_size + history_pos, history + history_pos, first);
+    simd::copy(history + m_window_size, history, second);
+
+    history_pos = (history_pos + numSamples) % m_window_size;
+}
+
+void WindowedPrePostProcessor::copyWindow(AudioBufferF& output, size_t channel, size_t offset) const {
+    simd::copy(output.getWritePointer(0, offset), m_history.getReadPointer(channel, m_history_pos[channel]), m_window_size);
+}
+
+} // namespace anira
@@ -1,4 +1,5 @@
 #include <anira/backends/BackendBase.h>
+#include <anira/utils/SimdKernels.h>
 
 namespace anira {
 BackendBase::BackendBase(InferenceConfig &config) : inferenceConfig(config) {
@@ -14,13 +15,8 @@ void BackendBase::processBlock(AudioBufferF &input, AudioBufferF &output) {
     auto sampleDiff = input.getNumSamples() - output.getNumSamples();
 
     if (equalChannels && sampleDiff == 0) {
-        for (int channel = 0; channel < input.getNumChannels(); ++channel) {
-            auto writePtr = output.getWritePointer(channel);
-            auto readPtr = input.getReadPointer(channel);
-
-            for (size_t i = 0; i < output.getNumSamples(); ++i) {
-                writePtr[i] = readPtr[i];
-            }
+        for (size_t channel = 0; channel < input.getNumChannels(); ++channel) {
+            simd::copy(output.getWritePointer(channel), input.getReadPointer(channel), output.getNumSamples());
         }
     }
     else {
@@ -28,4 +24,17 @@ void BackendBase::processBlock(AudioBufferF &input, AudioBufferF &output) {
     }
 }
 
+size_t BackendBase::getStateSize() {
+    return 0;
+}
+
+void BackendBase::saveState([[maybe_unused]] float* state) {
+}
+
+void BackendBase::restoreState([[maybe_unused]] const float* state) {
+}
+
+void BackendBase::resetState() {
+}
+
 }
\ No newline at end of file
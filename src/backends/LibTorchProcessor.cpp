@@ -1,36 +1,110 @@
 #include <anira/backends/LibTorchProcessor.h>
+#include <anira/utils/SimdKernels.h>
+#include <anira/utils/MemoryLock.h>
+#include <anira/utils/MappedFile.h>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <unordered_set>
 
 namespace anira {
 
+namespace {
+
+// Read-only stream over memory, torch::jit::load seeks in the stream, so get area reads alone are not enough
+class MemoryStreamBuffer : public std::streambuf {
+public:
+    MemoryStreamBuffer(const void* data, size_t size) {
+        char* begin = const_cast<char*>(static_cast<const char*>(data));
+        setg(begin, begin, begin + size);
+    }
+
+protected:
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode) override {
+        char* position = direction == std::ios_base::beg ? eback() : direction == std::ios_base::cur ? gptr() : egptr();
+        position += offset;
+        if (position < eback() || position > egptr()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), position, egptr());
+        return pos_type(position - eback());
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode mode) override {
+        return seekoff(off_type(position), std::ios_base::beg, mode);
+    }
+};
+
+}
+
 LibtorchProcessor::LibtorchProcessor(InferenceConfig& config) : BackendBase(config) {
     torch::set_num_threads(1);
     
     try {
-        module = torch::jit::load(inferenceConfig.m_model_path_torch);
+        if (inferenceConfig.m_map_models) {
+            // The weights are copied into the tensors, so the mapping is only needed while loading
+            std::shared_ptr<const MappedFile> mapped_model = MappedFile::open(inferenceConfig.m_model_path_torch, inferenceConfig.m_map_models_huge_pages);
+            MemoryStreamBuffer buffer(mapped_model->getData(), mapped_model->getSize());
+            std::istream stream(&buffer);
+            module = torch::jit::load(stream);
+        } else {
+            module = torch::jit::load(inferenceConfig.m_model_path_torch);
+        }
     }
-    catch (const c10::Error& e) {
+    // MappedFile throws std::runtime_error, torch::jit::load c10::Error
+    catch (const std::exception& e) {
         std::cerr << "[ERROR] error loading the model\n";
         std::cerr << e.what() << std::endl;
     }
 }
 
 LibtorchProcessor::~LibtorchProcessor() {
+    for (const auto& [ptr, size] : lockedWeights) {
+        unlockMemory(ptr, size);
+    }
 }
 
 void LibtorchProcessor::prepareToPlay() {
     inputs.clear();
     inputs.push_back(torch::zeros(inferenceConfig.m_model_input_shape_torch));
 
-    if (inferenceConfig.m_warm_up) {
+    resolveStateAttributes();
+
+    if (inferenceConfig.m_warm_up > 0) {
         AudioBufferF input(1, inferenceConfig.m_new_model_input_size);
         AudioBufferF output(1, inferenceConfig.m_new_model_output_size);
-        processBlock(input, output);
+        for (int i = 0; i < inferenceConfig.m_warm_up; ++i) {
+            processBlock(input, output);
+        }
+        // The warm up must not leave its state behind
+        resetState();
+    }
+
+    if (inferenceConfig.m_memory_lock != InferenceConfig::MemoryLockNone && lockedWeights.empty()) {
+        size_t failed_bytes = 0;
+        auto lock_tensor = [&] (const torch::Tensor& tensor) {
+            size_t size = (size_t) tensor.numel() * tensor.element_size();
+            if (lockMemory(tensor.data_ptr(), size)) {
+                lockedWeights.emplace_back(tensor.data_ptr(), size);
+            } else {
+                failed_bytes += size;
+            }
+        };
+        for (const auto& parameter : module.parameters()) {
+            lock_tensor(parameter);
+        }
+        for (const auto& buffer : module.buffers()) {
+            lock_tensor(buffer);
+        }
+        if (failed_bytes > 0) {
+            reportMemoryLockFailure("the libtorch model weights", failed_bytes);
+        }
     }
 }
 
 void LibtorchProcessor::processBlock(AudioBufferF& input, AudioBufferF& output) { 
     // Create input tensor object from input data values and shape
-    inputTensor = torch::from_blob(input.getRawData(), (const long long) input.getNumSamples()).reshape(inferenceConfig.m_model_input_shape_torch); // TODO: Multichannel support
+    inputTensor = torch::from_blob(input.getRawData(), (const long long) input.getNumSamples()).reshape(inferenceConfig.m_model_input_shape_torch);
 
     inputs[0] = inputTensor;
 
@@ -40,10 +114,108 @@ void LibtorchProcessor::processBlock(AudioBufferF& input, AudioBufferF& output)
     // Flatten the output tensor
     outputTensor = outputTensor.view({-1});
 
-    // Extract the output tensor data
-    for (size_t i = 0; i < inferenceConfig.m_new_model_output_size; i++) {
-        output.setSample(0, i, outputTensor[(int64_t) i].item<float>());
+    // Extract the output tensor data in one block instead of one tensor access per sample
+    simd::copy(output.getWritePointer(0), outputTensor.data_ptr<float>(), inferenceConfig.m_new_model_output_size);
+}
+
+void LibtorchProcessor::resolveStateAttributes() {
+    if (stateResolved) {
+        return;
     }
+    stateResolved = true;
+
+    try {
+        auto add_attribute = [&] (const torch::jit::script::Module& submodule, const std::string& attribute, const std::string& name) {
+            torch::Tensor tensor = submodule.attr(attribute).toTensor();
+            stateAttributes.push_back({name, submodule._ivalue(), submodule.type()->getAttributeSlot(attribute), tensor.numel()});
+            stateSize += (size_t) tensor.numel();
+        };
+
+        if (!inferenceConfig.m_state_attributes.empty()) {
+            for (const auto& path : inferenceConfig.m_state_attributes) {
+                torch::jit::script::Module submodule = module;
+                std::string attribute = path;
+                for (size_t dot = attribute.find('.'); dot != std::string::npos; dot = attribute.find('.')) {
+                    submodule = submodule.attr(attribute.substr(0, dot)).toModule();
+                    attribute = attribute.substr(dot + 1);
+                }
+                if (!submodule.hasattr(attribute) || !submodule.attr(attribute).isTensor() || submodule.attr(attribute).toTensor().scalar_type() != torch::kFloat) {
+                    throw std::runtime_error("the state attribute " + path + " is not a float tensor of the model");
+                }
+                add_attribute(submodule, attribute, path);
+            }
+        } else {
+            // Buffers hold values like the running statistics of batch norms, which do not change between inferences
+            for (const auto& named_module : module.named_modules()) {
+                std::unordered_set<std::string> weights;
+                for (const auto& parameter : named_module.value.named_parameters(false)) {
+                    weights.insert(parameter.name);
+                }
+                for (const auto& buffer : named_module.value.named_buffers(false)) {
+                    weights.insert(buffer.name);
+                }
+                for (const auto& attribute : named_module.value.named_attributes(false)) {
+                    if (attribute.value.isTensor() && attribute.value.toTensor().scalar_type() == torch::kFloat && weights.count(attribute.name) == 0) {
+                        add_attribute(named_module.value, attribute.name, named_module.name.empty() ? attribute.name : named_module.name + "." + attribute.name);
+                    }
+                }
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[ERROR] error resolving the state of the model\n";
+        std::cerr << e.what() << std::endl;
+        stateAttributes.clear();
+        stateSize = 0;
+    }
+
+    initialState.resize(stateSize);
+    saveState(initialState.data());
+}
+
+void LibtorchProcessor::reportStateSizeMismatch(const std::string& name, int64_t size, int64_t expectedSize) {
+    if (stateSizeMismatchReported) {
+        return;
+    }
+    stateSizeMismatchReported = true;
+    std::cerr << "[ERROR] The state tensor " << name << " of the model has " << size << " elements instead of " << expectedSize << ", it is no longer saved and restored" << std::endl;
+}
+
+size_t LibtorchProcessor::getStateSize() {
+    return stateSize;
+}
+
+void LibtorchProcessor::saveState(float* state) {
+    for (const auto& attribute : stateAttributes) {
+        const torch::Tensor& tensor = attribute.object->getSlot(attribute.slot).toTensor();
+        if (tensor.numel() != attribute.size) {
+            reportStateSizeMismatch(attribute.name, tensor.numel(), attribute.size);
+        } else if (tensor.is_contiguous()) {
+            simd::copy(state, tensor.data_ptr<float>(), (size_t) attribute.size);
+        } else {
+            torch::from_blob(state, tensor.sizes()).copy_(tensor);
+        }
+        state += attribute.size;
+    }
+}
+
+void LibtorchProcessor::restoreState(const float* state) {
+    torch::NoGradGuard no_grad;
+    for (const auto& attribute : stateAttributes) {
+        const torch::Tensor& tensor = attribute.object->getSlot(attribute.slot).toTensor();
+        if (tensor.numel() != attribute.size) {
+            reportStateSizeMismatch(attribute.name, tensor.numel(), attribute.size);
+        } else if (tensor.is_contiguous()) {
+            simd::copy(tensor.data_ptr<float>(), state, (size_t) attribute.size);
+        } else {
+            tensor.copy_(torch::from_blob(const_cast<float*>(state), tensor.sizes()));
+        }
+        state += attribute.size;
+    }
+}
+
+void LibtorchProcessor::resetState() {
+    restoreState(initialState.data());
 }
 
 } // namespace anira
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <anira/backends/OnnxRuntimeProcessor.h>
+#include <anira/utils/SimdKernels.h>
 
 namespace anira {
 
@@ -14,7 +15,23 @@ OnnxRuntimeProcessor::OnnxRuntimeProcessor(InferenceConfig& config) :
 #endif
 
     session_options.SetIntraOpNumThreads(1);
-    session = std::make_unique<Ort::Session>(env, modelpath.c_str(), session_options);
+    // MappedFile throws std::runtime_error, onnxruntime Ort::Exception
+    try {
+        if (inferenceConfig.m_map_models) {
+            mappedModel = MappedFile::open(inferenceConfig.m_model_path_onnx, inferenceConfig.m_map_models_huge_pages);
+            // Models in the ORT format are then used in place, .onnx models are still parsed into memory of the session
+            session_options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+            session_options.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+            session = std::make_unique<Ort::Session>(env, mappedModel->getData(), mappedModel->getSize(), session_options);
+        } else {
+            session = std::make_unique<Ort::Session>(env, modelpath.c_str(), session_options);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[ERROR] error loading the model\n";
+        std::cerr << e.what() << std::endl;
+        return;
+    }
 
     inputName = std::make_unique<Ort::AllocatedStringPtr>(session->GetInputNameAllocated(0, ort_alloc));
     outputName = std::make_unique<Ort::AllocatedStringPtr>(session->GetOutputNameAllocated(0, ort_alloc));
@@ -41,19 +58,22 @@ OnnxRuntimeProcessor::~OnnxRuntimeProcessor()
 }
 
 void OnnxRuntimeProcessor::prepareToPlay() {
-    if (inferenceConfig.m_warm_up) {
+    if (session != nullptr && inferenceConfig.m_warm_up > 0) {
         AudioBufferF input(1, inputSize);
         AudioBufferF output(1, outputSize);
-        processBlock(input, output);
+        for (int i = 0; i < inferenceConfig.m_warm_up; ++i) {
+            processBlock(input, output);
+        }
     }
 }
 
 void OnnxRuntimeProcessor::processBlock(AudioBufferF& input, AudioBufferF& output) {
-    auto inputWritePtr = inputTensor[0].GetTensorMutableData<float>();
-    auto inputReadPtr = input.getReadPointer(0);
-    for (size_t i = 0; i < inputSize; i++) {
-        inputWritePtr[i] = inputReadPtr[i];
+    // The model could not be loaded
+    if (session == nullptr) {
+        output.clear();
+        return;
     }
+    simd::copy(inputTensor[0].GetTensorMutableData<float>(), input.getReadPointer(0), inputSize);
 
     try {
         outputTensor = session->Run(Ort::RunOptions{nullptr}, inputNames.data(), inputTensor.data(), inputNames.size(), outputNames.data(), outputNames.size());
@@ -62,11 +82,7 @@ void OnnxRuntimeProcessor::processBlock(AudioBufferF& input, AudioBufferF& outpu
         std::cerr << e.what() << std::endl;
     }
 
-    auto outputWritePtr = output.getWritePointer(0);
-    auto outputReadPtr = outputTensor[0].GetTensorMutableData<float>();
-    for (size_t i = 0; i < outputSize; ++i) {
-        outputWritePtr[i] = outputReadPtr[i];
-    }
+    simd::copy(output.getWritePointer(0), outputTensor[0].GetTensorMutableData<float>(), outputSize);
 }
 
 } // namespace anira
\ No newline at end of file
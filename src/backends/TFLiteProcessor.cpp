@@ -15,12 +15,29 @@ TFLiteProcessor::TFLiteProcessor(InferenceConfig& config) : BackendBase(config)
     std::string modelpath = inferenceConfig.m_model_path_tflite;
 #endif
 
+    if (inferenceConfig.m_map_models) {
+        try {
+            mappedModel = MappedFile::open(inferenceConfig.m_model_path_tflite, inferenceConfig.m_map_models_huge_pages);
+            model = TfLiteModelCreate(mappedModel->getData(), mappedModel->getSize());
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] error loading the model\n";
+            std::cerr << e.what() << std::endl;
+            return;
+        }
+    } else {
 #ifdef _WIN32
-    _bstr_t modelPathChar (modelpath.c_str());
-    model = TfLiteModelCreateFromFile(modelPathChar);
+        _bstr_t modelPathChar (modelpath.c_str());
+        model = TfLiteModelCreateFromFile(modelPathChar);
 #else
-    model = TfLiteModelCreateFromFile(modelpath.c_str());
+        model = TfLiteModelCreateFromFile(modelpath.c_str());
 #endif
+    }
+
+    if (model == nullptr) {
+        std::cerr << "[ERROR] error loading the model" << std::endl;
+        return;
+    }
 
     options = TfLiteInterpreterOptionsCreate();
     TfLiteInterpreterOptionsSetNumThreads(options, 1);
@@ -38,21 +55,31 @@ TFLiteProcessor::~TFLiteProcessor()
 }
 
 void TFLiteProcessor::prepareToPlay() {
+    if (interpreter == nullptr) {
+        return;
+    }
     TfLiteInterpreterAllocateTensors(interpreter);
     inputTensor = TfLiteInterpreterGetInputTensor(interpreter, 0);
     outputTensor = TfLiteInterpreterGetOutputTensor(interpreter, 0);
 
-    if (inferenceConfig.m_warm_up) {
+    if (inferenceConfig.m_warm_up > 0) {
         AudioBufferF input(1, inferenceConfig.m_new_model_input_size);
         AudioBufferF output(1, inferenceConfig.m_new_model_output_size);
-        processBlock(input, output);
+        for (int i = 0; i < inferenceConfig.m_warm_up; ++i) {
+            processBlock(input, output);
+        }
     }
 }
 
 void TFLiteProcessor::processBlock(AudioBufferF& input, AudioBufferF& output) {
-    TfLiteTensorCopyFromBuffer(inputTensor, input.getRawData(), input.getNumSamples() * sizeof(float)); //TODO: Multichannel support
+    // The model could not be loaded
+    if (interpreter == nullptr) {
+        output.clear();
+        return;
+    }
+    TfLiteTensorCopyFromBuffer(inputTensor, input.getRawData(), input.getNumSamples() * sizeof(float));
     TfLiteInterpreterInvoke(interpreter);
-    TfLiteTensorCopyToBuffer(outputTensor, output.getRawData(), output.getNumSamples() * sizeof(float)); //TODO: Multichannel support
+    TfLiteTensorCopyToBuffer(outputTensor, output.getRawData(), output.getNumSamples() * sizeof(float));
 }
 
 } // namespace anira
\ No newline at end of file
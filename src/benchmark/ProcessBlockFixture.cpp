@@ -1,5 +1,8 @@
 #include <anira/benchmark/ProcessBlockFixture.h>
 
+#include <algorithm>
+#include <cstdlib>
+
 namespace anira {
 namespace benchmark {
 
@@ -65,7 +68,7 @@ void ProcessBlockFixture::initializeRepetition(const InferenceConfig& inferenceC
             m_hostAudioConfig = hostAudioConfig;
         }
         std::cout << "\n----------------------------------------------------------------------------------------------------------------------------------------" << std::endl;
-        std::cout << "Model: " << m_model_name << " | Backend: " << m_inference_backend_name << " | Sample Rate: " << std::fixed << std::setprecision(0) << m_hostAudioConfig.hostSampleRate << " Hz | Buffer Size: " << m_hostAudioConfig.hostBufferSize << " = " << std::fixed << std::setprecision(4) << (float) m_hostAudioConfig.hostBufferSize * 1000.f/m_hostAudioConfig.hostSampleRate << " ms" << std::endl;
+        std::cout << "Model: " << m_model_name << " | Backend: " << m_inference_backend_name << " | Sample Rate: " << std::fixed << std::setprecision(0) << m_hostAudioConfig.hostSampleRate << " Hz | Buffer Size: " << m_hostAudioConfig.hostBufferSize << " = " << std::fixed << std::setprecision(4) << (float) m_hostAudioConfig.hostBufferSize * 1000.f/m_hostAudioConfig.hostSampleRate << " ms" << (m_hostAudioConfig.variableBufferSize ? " (maximum, variable block sizes)" : "") << std::endl;
         std::cout << "----------------------------------------------------------------------------------------------------------------------------------------\n" << std::endl;
     }
 
@@ -87,6 +90,10 @@ int ProcessBlockFixture::getBufferSize() {
     return m_bufferSize;
 }
 
+int ProcessBlockFixture::getRandomBufferSize() {
+    return 1 + std::rand() % std::max(m_bufferSize, 1);
+}
+
 #if defined(_WIN32) || defined(__APPLE__)
 void ProcessBlockFixture::interationStep(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end, ::benchmark::State& state) {
 #else
@@ -109,16 +116,42 @@ void ProcessBlockFixture::repetitionStep() {
     std::cout << "\n----------------------------------------------------------------------------------------------------------------------------------------\n" << std::endl;
 }
 
+bool ProcessBlockFixture::dumpTrace(const std::string& path) {
+    if (!Tracer::isEnabled()) {
+        std::cout << "[WARNING] anira was built without ANIRA_WITH_TRACING, no trace was written to " << path << std::endl;
+        return false;
+    }
+    if (!Tracer::writeChromeTrace(path)) {
+        std::cout << "[ERROR] Could not write the trace to " << path << std::endl;
+        return false;
+    }
+    std::cout << "Trace with " << Tracer::getNumEvents() << " events (" << Tracer::getNumDroppedEvents() << " dropped) written to " << path << std::endl;
+    return true;
+}
+
+std::string ProcessBlockFixture::getTraceFileName(const ::benchmark::State& state) {
+    std::string name = state.name() + "_" + m_model_name + "_" + m_inference_backend_name + "_" + std::to_string(state.range(0)) + "_repetition" + std::to_string(m_repetition - 1) + ".json";
+    std::replace_if(name.begin(), name.end(), [] (char c) { return c == '/' || c == '\\' || c == ':' || c == ' '; }, '_');
+    return name;
+}
+
 void ProcessBlockFixture::SetUp(const ::benchmark::State& state) {
     if (m_bufferSize != (int) state.range(0)) {
         m_bufferSize = (int) state.range(0);
     }
+    // Every repetition gets its own trace
+    Tracer::clear();
 }
 
 void ProcessBlockFixture::TearDown(const ::benchmark::State& state) {
     m_buffer.reset();
     m_inferenceHandler.reset();
 
+    const char* trace_dir = std::getenv("ANIRA_TRACE_DIR");
+    if (trace_dir != nullptr && Tracer::isEnabled()) {
+        dumpTrace(std::string(trace_dir) + "/" + getTraceFileName(state));
+    }
+
     if (m_sleep_after_repetition) {
         std::this_thread::sleep_for(m_runtime_last_repetition);
     }
@@ -1,34 +1,111 @@
 #include <anira/scheduler/InferenceManager.h>
+#include <anira/utils/SimdKernels.h>
+#include <algorithm>
+#include <cmath>
 
 namespace anira {
 
 InferenceManager::InferenceManager(PrePostProcessor& ppP, InferenceConfig& config, BackendBase& noneProcessor) :
     inferenceThreadPool(InferenceThreadPool::getInstance(config)),
     session(inferenceThreadPool->createSession(ppP, config, noneProcessor)),
-    inferenceConfig(config)
+    inferenceConfig(config),
+    telemetryDrainer(session.telemetry)
 {
+    if (config.m_synchronous || config.m_audio_thread_assist) {
+        callbackWorker = std::make_unique<InferenceThread>(InferenceThreadPool::global_counter, config, InferenceThreadPool::getSessions());
+    }
+    if constexpr (ANIRA_TELEMETRY_LEVEL > TELEMETRY_OFF) {
+        telemetryDrainer.start();
+    }
 }
 
 InferenceManager::~InferenceManager() {
+    // The drainer reads from the ring of the session, so it has to stop before the session is released
+    telemetryDrainer.stop();
     inferenceThreadPool->releaseSession(session, inferenceConfig);
 }
 
 void InferenceManager::setBackend(InferenceBackend newInferenceBackend) {
-    session.currentBackend = newInferenceBackend;
+    selectedBackend = newInferenceBackend;
+    if (!degraded) {
+        session.currentBackend = newInferenceBackend;
+    }
+    session.telemetry.record<TelemetryEventType::BackendSwitch>(session.sessionID, (int64_t) newInferenceBackend);
 }
 
 InferenceBackend InferenceManager::getBackend() {
-    return session.currentBackend;
+    return selectedBackend;
+}
+
+void InferenceManager::setOfflineMode(bool offline) {
+    offlineMode = offline;
+}
+
+bool InferenceManager::isOfflineMode() const {
+    return offlineMode;
+}
+
+void InferenceManager::setDegradationPolicy(const DegradationPolicy& policy) {
+    degradationPolicy = policy;
+}
+
+bool InferenceManager::isDegraded() const {
+    return degraded.load();
 }
 
 void InferenceManager::prepare(HostAudioConfig newConfig) {
     spec = newConfig;
 
+    degraded = false;
+    session.currentBackend = selectedBackend.load();
+
     inferenceThreadPool->prepare(session, spec);
 
-    inferenceCounter = 0;
+    // The inference times do not depend on the host config, so the backends are only calibrated once
+    if (inferenceConfig.m_calibrate && !calibrated) {
+        calibrate();
+        calibrated = true;
+        // Size the inference queue with the calibrated times
+        inferenceThreadPool->prepare(session, spec);
+    }
+
+    missingSamples = 0;
+
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        latencies[i] = calculateLatency((InferenceBackend) i);
+    }
+    latencyBackend = selectedBackend.load();
+    if (spec.variableBufferSize) {
+        maxInferencesPerBuffer = ((int) spec.hostBufferSize + (int) session.numNewSamples - 1) / (int) session.numNewSamples;
+    } else {
+        maxInferencesPerBuffer = maxNumberOfInferences(spec.hostBufferSize, (int) session.numNewSamples);
+    }
+    session.statistics.setLatency(latencies[latencyBackend]);
+    initSamples = (size_t) latencies[latencyBackend].totalLatency;
+    session.inferenceDeadline = getInferenceDeadline();
+    inferenceThreadPool->updateDeadlineScheduling();
+
+    lastInferenceTime = HistogramSnapshot();
+    lastQueueWaitTime = HistogramSnapshot();
+    samplesSinceEvaluation = 0;
+    samplesWaitingForSilence = 0;
+    shrinkIntervals = 0;
+    pendingLatencyChange = 0;
+    fadeInPending = false;
+    lastBlockSilent = false;
+    degradationInferenceTime = HistogramSnapshot();
+    degradationQueueWaitTime = HistogramSnapshot();
+    samplesSinceDegradationCheck = 0;
+    samplesDegraded = 0;
+    samplesSinceRecovery = 0;
+    recoveryTime = degradationPolicy.recoveryTime;
+    consecutiveMisses = 0;
+
+    if (inferenceConfig.m_adaptive_latency) {
+        // A shrink reads up to one block ahead
+        latencyChangeBuffer.initialize(spec.hostChannels, 2 * spec.hostBufferSize);
+    }
 
-    initSamples = calculateLatency();
     for (size_t i = 0; i < spec.hostChannels; ++i) {
         for (size_t j = 0; j < initSamples; ++j) {
             session.receiveBuffer.pushSample(i, 0.f);
@@ -37,70 +114,386 @@ void InferenceManager::prepare(HostAudioConfig newConfig) {
 }
 
 void InferenceManager::process(float ** inputBuffer, size_t inputSamples) {
+    InferenceBackend backend = selectedBackend.load();
+    if (backend != latencyBackend) {
+        adaptLatency(backend);
+    }
+    if (!degraded && session.currentBackend.load() != backend) {
+        session.currentBackend = backend;
+    }
+
     processInput(inputBuffer, inputSamples);
 
+    if (inferenceConfig.m_synchronous) {
+        inferenceThreadPool->newDataProcessedSynchronous(session, *callbackWorker);
+        processOutput(inputBuffer, inputSamples);
+        return;
+    }
+
+    if (offlineMode) {
+        inferenceThreadPool->newDataSubmittedBlocking(session);
+        inferenceThreadPool->newDataRequestBlocking(session, inputSamples);
+        processOutput(inputBuffer, inputSamples);
+        return;
+    }
+
     inferenceThreadPool->newDataSubmitted(session);
     double timeInSec = static_cast<double>(inputSamples) / spec.hostSampleRate;
     inferenceThreadPool->newDataRequest(session, timeInSec);
+    if (inferenceConfig.m_audio_thread_assist) {
+        inferenceThreadPool->newDataRequestAssisted(session, *callbackWorker, inputSamples);
+    }
 
+    if (inferenceConfig.m_adaptive_latency) {
+        updateAdaptiveLatency(inputSamples);
+    }
     processOutput(inputBuffer, inputSamples);
+
+    if (degradationPolicy.enabled) {
+        updateDegradation(inputSamples);
+    }
 }
 
-void InferenceManager::processInput(float ** inputBuffer, size_t inputSamples) {
+void InferenceManager::calibrate() {
+    std::unique_ptr<CalibrationCache> cache;
+    if (!inferenceConfig.m_calibration_cache_path.empty()) {
+        cache = std::make_unique<CalibrationCache>(inferenceConfig.m_calibration_cache_path);
+    }
+    size_t num_inferences = (size_t) std::max(inferenceConfig.m_calibration_inferences, 1);
+
+    for (size_t i = 0; i < session.maxInferenceTimes.size(); ++i) {
+        InferenceBackend backend = (InferenceBackend) i;
+        if (backend != NONE && inferenceConfig.getModelPath(backend).empty()) {
+            continue;
+        }
+
+        std::string key;
+        float max_inference_time;
+        if (cache != nullptr) {
+            key = CalibrationCache::getKey(inferenceConfig, backend);
+            if (cache->get(key, max_inference_time)) {
+                session.maxInferenceTimes[i] = max_inference_time;
+                continue;
+            }
+        }
+
+        // Warm up runs, so lazy initialization in the backends does not end up in the measurement
+        inferenceThreadPool->measureInferenceTimes(session, backend, std::max<size_t>(num_inferences / 10, 1));
+        std::vector<float> inference_times = inferenceThreadPool->measureInferenceTimes(session, backend, num_inferences);
+        if (inference_times.size() < num_inferences) {
+#ifndef BELA
+            std::cout << "[WARNING] Calibration of backend " << getInferenceBackendName(backend) << " failed, using the max inference time of " << inferenceConfig.m_max_inference_time << " ms" << std::endl;
+#else
+            printf("[WARNING] Calibration of backend %s failed, using the max inference time of %f ms\n", getInferenceBackendName(backend), inferenceConfig.m_max_inference_time);
+#endif
+            continue;
+        }
+
+        std::sort(inference_times.begin(), inference_times.end());
+        float rank = std::ceil(std::clamp(inferenceConfig.m_calibration_percentile, 0.f, 100.f) / 100.f * (float) inference_times.size());
+        max_inference_time = inference_times[(size_t) std::clamp<float>(rank - 1.f, 0.f, (float) inference_times.size() - 1.f)];
+        session.maxInferenceTimes[i] = max_inference_time;
+
+        if (cache != nullptr && !cache->set(key, max_inference_time)) {
+#ifndef BELA
+            std::cout << "[WARNING] Could not write the calibration cache " << inferenceConfig.m_calibration_cache_path << std::endl;
+#else
+            printf("[WARNING] Could not write the calibration cache %s\n", inferenceConfig.m_calibration_cache_path.c_str());
+#endif
+        }
+    }
+}
+
+void InferenceManager::adaptLatency(InferenceBackend newBackend) {
+    // Calibrated backends can have different latencies, the difference is added as silence or dropped from the receive buffer
+    int difference = latencies[newBackend].totalLatency - latencies[latencyBackend].totalLatency;
     for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
-        for (size_t sample = 0; sample < inputSamples; ++sample) {
-            session.sendBuffer.pushSample(0, inputBuffer[channel][sample]);
+        if (difference > 0) {
+            for (int i = 0; i < difference; ++i) {
+                session.receiveBuffer.pushSample(channel, 0.f);
+            }
+        } else if (difference < 0) {
+            session.receiveBuffer.discardSamples(channel, std::min((size_t) -difference, session.receiveBuffer.getAvailableSamples(channel)));
         }
     }
+    latencyBackend = newBackend;
+    initSamples = (size_t) latencies[newBackend].totalLatency;
+    session.statistics.setLatency(latencies[newBackend]);
+    if (difference != 0) {
+        session.telemetry.record<TelemetryEventType::LatencyChange>(session.sessionID, (int64_t) initSamples.load());
+    }
+}
+
+void InferenceManager::updateAdaptiveLatency(size_t inputSamples) {
+    samplesSinceEvaluation += inputSamples;
+    if ((double) samplesSinceEvaluation < ADAPTIVE_LATENCY_INTERVAL * spec.hostSampleRate) {
+        return;
+    }
+    samplesSinceEvaluation = 0;
+
+    // Copying the histograms takes a few hundred relaxed loads and does not allocate
+    SessionStatisticsSnapshot statistics = session.statistics.getSnapshot(latencyBackend);
+    HistogramSnapshot inference_time = statistics.inferenceTime.since(lastInferenceTime);
+    HistogramSnapshot queue_wait_time = statistics.queueWaitTime.since(lastQueueWaitTime);
+    lastInferenceTime = statistics.inferenceTime;
+    lastQueueWaitTime = statistics.queueWaitTime;
+    if (inference_time.count < ADAPTIVE_LATENCY_MIN_INFERENCES) {
+        return;
+    }
+
+    float percentile = std::clamp(inferenceConfig.m_adaptive_latency_percentile, 0.f, 100.f);
+    float max_inference_time = (float) ((inference_time.getPercentile(percentile) + queue_wait_time.getPercentile(percentile)) * 1e-6);
+    // Only the inference caused part of the latency depends on the inference time
+    int target = calculateLatency(max_inference_time).inferenceCausedLatency;
+    // The receive buffer of the session has no room for more
+    target = std::min(target, (int) session.maxLatency - latencies[latencyBackend].bufferAdaptation - latencies[latencyBackend].modelLatency);
+    int difference = target - (latencies[latencyBackend].inferenceCausedLatency + pendingLatencyChange);
+
+    if (difference > 0) {
+        pendingLatencyChange += difference;
+        shrinkIntervals = 0;
+    } else if (difference < 0) {
+        // Shrinking is only worth the crossfade when the headroom is stable
+        if (++shrinkIntervals >= ADAPTIVE_LATENCY_SHRINK_INTERVALS) {
+            pendingLatencyChange += difference;
+            shrinkIntervals = 0;
+            samplesWaitingForSilence = 0;
+        }
+    } else {
+        shrinkIntervals = 0;
+    }
+}
+
+bool InferenceManager::applyLatencyChange(float ** outputBuffer, size_t outputSamples) {
+    size_t fade_length = std::min(outputSamples / 4, ADAPTIVE_LATENCY_FADE_LENGTH);
+    size_t available_samples = session.receiveBuffer.getMinAvailableSamples();
+
+    if (pendingLatencyChange > 0) {
+        // Grow: the block ends early with a fade out and the rest is silence, the next block fades in again
+        size_t gap = std::min((size_t) pendingLatencyChange, outputSamples - 2 * fade_length);
+        size_t num_signal = outputSamples - gap;
+        if (gap == 0 || available_samples < num_signal) {
+            return false;
+        }
+        for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
+            float* output = outputBuffer[channel];
+            session.receiveBuffer.popSamples(channel, output, num_signal);
+            for (size_t i = 0; i < fade_length; ++i) {
+                float gain = (float) (i + 1) / (float) (fade_length + 1);
+                if (fadeInPending) {
+                    output[i] *= gain;
+                }
+                output[num_signal - 1 - i] *= gain;
+            }
+            simd::clear(output + num_signal, gap);
+        }
+        pendingLatencyChange -= (int) gap;
+        fadeInPending = true;
+        latencyChanged((int) gap);
+        return true;
+    }
+
+    // Shrink: wait for a silent block, so skipping samples is inaudible, but not forever
+    if (!lastBlockSilent && (double) samplesWaitingForSilence < ADAPTIVE_LATENCY_MAX_SILENCE_WAIT * spec.hostSampleRate) {
+        samplesWaitingForSilence += outputSamples;
+        return false;
+    }
+    if (available_samples <= outputSamples) {
+        return false;
+    }
+    size_t skip = std::min({(size_t) -pendingLatencyChange, outputSamples, available_samples - outputSamples});
+    for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
+        float* samples = latencyChangeBuffer.getWritePointer(channel);
+        float* output = outputBuffer[channel];
+        session.receiveBuffer.popSamples(channel, samples, outputSamples + skip);
+        // Crossfade from the old read position to the one skip samples ahead
+        for (size_t i = 0; i < fade_length; ++i) {
+            float gain = (float) (i + 1) / (float) (fade_length + 1);
+            output[i] = samples[i] * (1.f - gain) + samples[i + skip] * gain;
+        }
+        simd::copy(output + fade_length, samples + fade_length + skip, outputSamples - fade_length);
+    }
+    pendingLatencyChange += (int) skip;
+    samplesWaitingForSilence = 0;
+    latencyChanged(-(int) skip);
+    return true;
+}
+
+void InferenceManager::updateDegradation(size_t inputSamples) {
+    samplesSinceDegradationCheck += inputSamples;
+    bool check = (double) samplesSinceDegradationCheck >= DEGRADATION_INTERVAL * spec.hostSampleRate;
+    HistogramSnapshot inference_time;
+    HistogramSnapshot queue_wait_time;
+    if (check) {
+        samplesSinceDegradationCheck = 0;
+        // Copying the histograms takes a few hundred relaxed loads and does not allocate
+        SessionStatisticsSnapshot statistics = session.statistics.getSnapshot(session.currentBackend.load());
+        inference_time = statistics.inferenceTime.since(degradationInferenceTime);
+        queue_wait_time = statistics.queueWaitTime.since(degradationQueueWaitTime);
+        degradationInferenceTime = statistics.inferenceTime;
+        degradationQueueWaitTime = statistics.queueWaitTime;
+    }
+    float percentile = std::clamp(degradationPolicy.percentile, 0.f, 100.f);
+    float recent_time = inference_time.count > 0 ? (float) ((inference_time.getPercentile(percentile) + queue_wait_time.getPercentile(percentile)) * 1e-6) : 0.f;
+    float deadline = getInferenceDeadline();
+
+    if (!degraded) {
+        samplesSinceRecovery += inputSamples;
+        bool overload = degradationPolicy.maxConsecutiveMisses > 0 && consecutiveMisses >= degradationPolicy.maxConsecutiveMisses;
+        if (check && degradationPolicy.overloadRatio > 0.f && deadline > 0.f && inference_time.count >= ADAPTIVE_LATENCY_MIN_INFERENCES) {
+            overload |= recent_time > degradationPolicy.overloadRatio * deadline;
+        }
+        if (overload && degradationPolicy.fallbackBackend != selectedBackend.load()) {
+            enterFallback();
+        }
+    } else {
+        samplesDegraded += inputSamples;
+        if (check && (double) samplesDegraded >= recoveryTime * spec.hostSampleRate && recent_time <= degradationPolicy.recoveryRatio * deadline) {
+            leaveFallback();
+        }
+    }
+}
+
+void InferenceManager::enterFallback() {
+    // The selected backend overloaded again shortly after the last recovery, so wait longer before the next attempt
+    if ((double) samplesSinceRecovery < recoveryTime * spec.hostSampleRate) {
+        recoveryTime = std::min(recoveryTime * 2.f, degradationPolicy.maxRecoveryTime);
+    } else {
+        recoveryTime = degradationPolicy.recoveryTime;
+    }
+    degraded = true;
+    session.currentBackend = degradationPolicy.fallbackBackend;
+    samplesDegraded = 0;
+    consecutiveMisses = 0;
+    // The window of the next check only holds inferences of the fallback
+    samplesSinceDegradationCheck = 0;
+    SessionStatisticsSnapshot statistics = session.statistics.getSnapshot(session.currentBackend.load());
+    degradationInferenceTime = statistics.inferenceTime;
+    degradationQueueWaitTime = statistics.queueWaitTime;
+    session.statistics.setDegraded(true);
+    session.telemetry.record<TelemetryEventType::Fallback>(session.sessionID, (int64_t) degradationPolicy.fallbackBackend);
+}
+
+void InferenceManager::leaveFallback() {
+    degraded = false;
+    session.currentBackend = selectedBackend.load();
+    samplesSinceRecovery = 0;
+    consecutiveMisses = 0;
+    samplesSinceDegradationCheck = 0;
+    SessionStatisticsSnapshot statistics = session.statistics.getSnapshot(session.currentBackend.load());
+    degradationInferenceTime = statistics.inferenceTime;
+    degradationQueueWaitTime = statistics.queueWaitTime;
+    session.statistics.setDegraded(false);
+    session.telemetry.record<TelemetryEventType::Recovery>(session.sessionID, (int64_t) session.currentBackend.load());
+}
+
+// Time in ms one inference may take without missing a block at the current latency
+float InferenceManager::getInferenceDeadline() const {
+    int inference_caused_samples = latencies[latencyBackend].inferenceCausedLatency;
+    if (spec.variableBufferSize) {
+        // The samples until the block that completes the model input arrives are no time for the inference
+        inference_caused_samples -= (int) spec.hostBufferSize - 1;
+    }
+    float inference_caused_latency = (float) inference_caused_samples * 1000.f / (float) spec.hostSampleRate;
+    return (inference_caused_latency + inferenceConfig.m_wait_in_process_block * (float) spec.hostBufferSize * 1000.f / (float) spec.hostSampleRate) / (float) maxInferencesPerBuffer;
+}
+
+void InferenceManager::latencyChanged(int difference) {
+    latencies[latencyBackend].inferenceCausedLatency += difference;
+    latencies[latencyBackend].totalLatency += difference;
+    initSamples = (size_t) latencies[latencyBackend].totalLatency;
+    session.statistics.setLatency(latencies[latencyBackend]);
+    // Hosts are only told about the final latency of a change that spans several blocks
+    if (pendingLatencyChange == 0) {
+        session.telemetry.record<TelemetryEventType::LatencyChange>(session.sessionID, (int64_t) initSamples.load());
+    }
+}
+
+void InferenceManager::processInput(float ** inputBuffer, size_t inputSamples) {
+    for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
+        session.sendBuffer.pushSamples(channel, inputBuffer[channel], inputSamples);
+    }
 }
 
 void InferenceManager::processOutput(float ** inputBuffer, size_t inputSamples) {    
-    while (inferenceCounter > 0) {
-        if (session.receiveBuffer.getAvailableSamples(0) >= 2 * (size_t) inputSamples) {
+    if (inferenceConfig.m_adaptive_latency && pendingLatencyChange != 0 && applyLatencyChange(inputBuffer, inputSamples)) {
+        consecutiveMisses = 0;
+        return;
+    }
+    // Missed samples are counted individually, so that the catch up also works when the block size changes between calls
+    while (missingSamples > 0) {
+        size_t catch_up = std::min((size_t) missingSamples.load(), inputSamples);
+        if (session.receiveBuffer.getMinAvailableSamples() >= inputSamples + catch_up) {
             for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
-                for (size_t sample = 0; sample < inputSamples; ++sample) {
-                    session.receiveBuffer.popSample(channel);
-                }
+                session.receiveBuffer.discardSamples(channel, catch_up);
             }
-            inferenceCounter--;
-#ifndef BELA
-            std::cout << "[WARNING] Catch up samples!" << std::endl;
-#else
-            printf("[WARNING] Catch up samples!");
-#endif
+            missingSamples -= (int) catch_up;
+            session.statistics.recordCaughtUpBlock();
+            session.telemetry.record<TelemetryEventType::CatchUpSamples>(session.sessionID, (int64_t) catch_up);
         }
         else {
             break;
         }
     }
-    if (session.receiveBuffer.getAvailableSamples(0) >= (size_t) inputSamples) {
+    // Parallel channels are collected one after another, so only the samples that every channel has are ready
+    if (session.receiveBuffer.getMinAvailableSamples() >= (size_t) inputSamples) {
         for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
-            for (size_t sample = 0; sample < inputSamples; ++sample) {
-                inputBuffer[channel][sample] = session.receiveBuffer.popSample(channel);
+            session.receiveBuffer.popSamples(channel, inputBuffer[channel], inputSamples);
+        }
+        consecutiveMisses = 0;
+        if (fadeInPending) {
+            size_t fade_length = std::min(inputSamples / 4, ADAPTIVE_LATENCY_FADE_LENGTH);
+            for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
+                for (size_t i = 0; i < fade_length; ++i) {
+                    inputBuffer[channel][i] *= (float) (i + 1) / (float) (fade_length + 1);
+                }
             }
+            fadeInPending = false;
         }
     }
     else {
         clearBuffer(inputBuffer, inputSamples);
-        inferenceCounter++;
-#ifndef BELA
-            std::cout << "[WARNING] Missing samples!" << std::endl;
-#else
-            printf("[WARNING] Missing samples!\n");
-#endif
+        session.statistics.recordMissedBlock();
+        session.telemetry.record<TelemetryEventType::MissingSamples>(session.sessionID, (int64_t) inputSamples);
+        consecutiveMisses++;
+        if (inferenceConfig.m_adaptive_latency) {
+            // The output was already interrupted, so instead of catching up later the missing block becomes additional latency
+            pendingLatencyChange = std::max(pendingLatencyChange - (int) inputSamples, 0);
+            shrinkIntervals = 0;
+            fadeInPending = true;
+            latencyChanged((int) inputSamples);
+        } else {
+            missingSamples += (int) inputSamples;
+        }
+    }
+
+    if (inferenceConfig.m_adaptive_latency) {
+        float peak = 0.f;
+        for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
+            for (size_t i = 0; i < inputSamples; ++i) {
+                peak = std::max(peak, std::abs(inputBuffer[channel][i]));
+            }
+        }
+        lastBlockSilent = peak < ADAPTIVE_LATENCY_SILENCE_THRESHOLD;
     }
 }
 
 void InferenceManager::clearBuffer(float ** inputBuffer, size_t inputSamples) {
     for (size_t channel = 0; channel < spec.hostChannels; ++channel) {
-        for (size_t sample = 0; sample < inputSamples; ++sample) {
-            inputBuffer[channel][sample] = 0.f;
-        }
+        simd::clear(inputBuffer[channel], inputSamples);
     }
 }
 
 int InferenceManager::getLatency() const {
-    return initSamples;
+    return (int) initSamples.load();
+}
+
+int InferenceManager::getLatency(InferenceBackend backend) const {
+    return latencies[backend].totalLatency;
+}
+
+float InferenceManager::getMaxInferenceTime(InferenceBackend backend) const {
+    return session.maxInferenceTimes[backend];
 }
 
 InferenceThreadPool& InferenceManager::getInferenceThreadPool() {
@@ -109,41 +502,112 @@ InferenceThreadPool& InferenceManager::getInferenceThreadPool() {
 
 size_t InferenceManager::getNumReceivedSamples() {
     inferenceThreadPool->newDataRequest(session, 0); // TODO: Check if processOutput call is better here
-    return session.receiveBuffer.getAvailableSamples(0);
+    return session.receiveBuffer.getMinAvailableSamples();
 }
 
 int InferenceManager::getMissingBlocks() {
-    return inferenceCounter.load();
+    return (missingSamples.load() + (int) spec.hostBufferSize - 1) / (int) spec.hostBufferSize;
+}
+
+void InferenceManager::setTelemetryListener(TelemetryDrainer::Listener listener) {
+    telemetryListener = std::move(listener);
+    updateTelemetryListener();
+}
+
+void InferenceManager::setLatencyListener(std::function<void(int)> listener) {
+    latencyListener = std::move(listener);
+    updateTelemetryListener();
+}
+
+void InferenceManager::updateTelemetryListener() {
+    if (!telemetryListener && !latencyListener) {
+        telemetryDrainer.setListener(nullptr);
+        return;
+    }
+    telemetryDrainer.setListener([telemetry = telemetryListener, latency = latencyListener] (const TelemetryEvent& event) {
+        if (latency && event.type == TelemetryEventType::LatencyChange) {
+            latency((int) event.value);
+        }
+        if (telemetry) {
+            telemetry(event);
+        } else {
+            TelemetryDrainer::print(event);
+        }
+    });
+}
+
+void InferenceManager::setTelemetryAutoDrain(bool autoDrain) {
+    if (autoDrain) {
+        telemetryDrainer.start();
+    } else {
+        telemetryDrainer.stop();
+    }
+}
+
+bool InferenceManager::pollTelemetry(TelemetryEvent& event) {
+    return session.telemetry.pop(event);
+}
+
+SessionStatisticsSnapshot InferenceManager::getStatistics() const {
+    return session.statistics.getSnapshot(session.currentBackend.load());
 }
 
 int InferenceManager::getSessionID() const {
     return session.sessionID;
 }
 
-int InferenceManager::calculateLatency() {
+LatencyBreakdown InferenceManager::calculateLatency(InferenceBackend backend) {
+    return calculateLatency(session.maxInferenceTimes[backend]);
+}
+
+LatencyBreakdown InferenceManager::calculateLatency(float maxInferenceTime) {
     // First calculate some universal values
-    int modelOutputSize = inferenceConfig.m_new_model_output_size;
+    int modelOutputSize = (int) session.numNewSamples;
     float hostBufferTime = (float) spec.hostBufferSize * 1000.f / (float) spec.hostSampleRate;
-#ifndef USE_SEMAPHORE
-    if (inferenceConfig.m_wait_in_process_block != 0.f) {
-        std::cout << "[WARNING] Using a wait time in process block of 0 ms. Wait time is not supported without semaphores." << std::endl;
-        inferenceConfig.m_wait_in_process_block = 0.f;
-    }
-#endif
     float waitTime = inferenceConfig.m_wait_in_process_block * hostBufferTime;
 
     // Then caclulate the different parts of the latency
-    int bufferAdaptation = calculateBufferAdaptation(spec.hostBufferSize, modelOutputSize);
-
-    int maxPossibleInferences = maxNumberOfInferences(spec.hostBufferSize, modelOutputSize);
-    float totalInferenceTimeAfterWait = (maxPossibleInferences * inferenceConfig.m_max_inference_time) - waitTime;
-    int numBuffersForMaxInferences = std::ceil(totalInferenceTimeAfterWait / hostBufferTime);
-    int inferenceCausedLatency = numBuffersForMaxInferences * spec.hostBufferSize;
+    int bufferAdaptation;
+    int maxPossibleInferences;
+    if (spec.variableBufferSize) {
+        // Any block size up to hostBufferSize can arrive, so the last model output may be missing up to modelOutputSize - 1 samples
+        bufferAdaptation = modelOutputSize - 1;
+        maxPossibleInferences = ((int) spec.hostBufferSize + modelOutputSize - 1) / modelOutputSize;
+    } else {
+        bufferAdaptation = calculateBufferAdaptation(spec.hostBufferSize, modelOutputSize);
+        maxPossibleInferences = maxNumberOfInferences(spec.hostBufferSize, modelOutputSize);
+    }
+    if (session.channelParallel) {
+        // The channels of one round run side by side as far as there are inference threads, stateful sessions run them one after another
+        int numThreads = (inferenceConfig.m_bind_session_to_thread || inferenceConfig.m_stateful) ? 1 : std::max(inferenceConfig.m_number_of_threads, 1);
+        maxPossibleInferences *= ((int) session.numChannels + numThreads - 1) / numThreads;
+    }
+    float totalInferenceTimeAfterWait = (maxPossibleInferences * maxInferenceTime) - waitTime;
+    int inferenceCausedLatency;
+    if (spec.variableBufferSize) {
+        // The block that completes a model input can end up to hostBufferSize - 1 samples later and the next block can be a single sample,
+        // so the inference time is not rounded to whole buffers
+        int inferenceTimeInSamples = std::max((int) std::ceil(totalInferenceTimeAfterWait * (float) spec.hostSampleRate / 1000.f), 0);
+        inferenceCausedLatency = (int) spec.hostBufferSize - 1 + inferenceTimeInSamples;
+    } else {
+        int numBuffersForMaxInferences = std::ceil(totalInferenceTimeAfterWait / hostBufferTime);
+        inferenceCausedLatency = numBuffersForMaxInferences * spec.hostBufferSize;
+    }
+    // Offline, process() waits for the inferences instead of covering them with latency, synchronous it runs them itself
+    if (offlineMode || inferenceConfig.m_synchronous) {
+        inferenceCausedLatency = 0;
+    }
 
     int modelCausedLatency = inferenceConfig.m_model_latency;
 
     // Add it all together
-    return bufferAdaptation + inferenceCausedLatency + modelCausedLatency;
+    LatencyBreakdown latency;
+    latency.bufferAdaptation = bufferAdaptation;
+    latency.inferenceCausedLatency = inferenceCausedLatency;
+    latency.modelLatency = modelCausedLatency;
+    latency.totalLatency = bufferAdaptation + inferenceCausedLatency + modelCausedLatency;
+
+    return latency;
 }
 
 
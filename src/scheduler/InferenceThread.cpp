@@ -41,6 +41,10 @@ InferenceThread::InferenceThread(std::atomic<int>& g, InferenceConfig& config, s
 
 void InferenceThread::run() {
     std::chrono::microseconds timeForExit(50);
+#ifdef ANIRA_TRACING
+    // Allocates the trace buffer of this thread before the first inference
+    Tracer::registerThread();
+#endif
     while (!shouldExit()) {
 #ifdef USE_SEMAPHORE
         if (m_global_counter.try_acquire()) {
@@ -53,80 +57,232 @@ void InferenceThread::run() {
         if (success) {
 #endif
             bool inference_done = false;
-            while (!inference_done) {
-                if (sessionID < 0) {
-                    for (const auto& session : sessions) {
+            if (sessionID < 0) {
+                for (const auto& session : sessions) {
+                    // The backends of the shared threads do not hold the hidden state of a bound session
+                    if (session->boundToThread) continue;
+                    inference_done = tryInference(session);
+                    if (inference_done) break;
+                }
+            } else {
+                for (const auto& session : sessions) {
+                    if (session->sessionID == sessionID) {
                         inference_done = tryInference(session);
-                        if (inference_done) break;
-                    }
-                } else {
-                    for (const auto& session : sessions) {
-                        if (session->sessionID == sessionID) {
-                            inference_done = tryInference(session);
-                            break;
-                        }
+                        break;
                     }
                 }
             }
+            if (!inference_done) {
+                // The pending inferences belong to stateful sessions that are running on other threads, hand the job back instead of spinning until they are done
+#ifdef USE_SEMAPHORE
+                m_global_counter.release();
+#else
+                m_global_counter.fetch_add(1);
+#endif
+                yieldUnlessDeadlineScheduled();
+                std::this_thread::sleep_for(timeForExit);
+            }
         }
         else {
-            std::this_thread::yield();
+            yieldUnlessDeadlineScheduled();
             std::this_thread::sleep_for(timeForExit);
         }
     }
 }
 
+// Under SCHED_DEADLINE a yield gives up the rest of the runtime until the next period, so new work would wait up to a whole period
+void InferenceThread::yieldUnlessDeadlineScheduled() {
+    if (!isDeadlineScheduled()) {
+        std::this_thread::yield();
+    }
+}
+
+void InferenceThread::processSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot) {
+    ANIRA_TRACE(Dequeue, session.sessionID, (unsigned int) slot.timeStamp);
+    inference(session, slot);
+    ANIRA_TRACE(Done, session.sessionID, (unsigned int) slot.timeStamp);
+}
+
 bool InferenceThread::tryInference(std::shared_ptr<SessionElement> session) {
+    // Only one thread at a time runs the inferences of a stateful session, so that every inference continues from the state of the previous one
+    bool stateful = session->inferenceConfig.m_stateful;
+    if (stateful && session->stateLocked.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
 #ifdef USE_SEMAPHORE
-    if (session->m_session_counter.try_acquire()) {
-        while (true) {
-            for (size_t i = 0; i < session->inferenceQueue.size(); ++i) {
-                if (session->inferenceQueue[i]->ready.try_acquire()) {
-                    inference(session, session->inferenceQueue[i]->processedModelInput, session->inferenceQueue[i]->rawModelOutput);
-                    session->inferenceQueue[i]->done.release();
-                    return true;
-                }
+    bool success = session->m_session_counter.try_acquire();
+#else
+    int old = session->m_session_counter.load();
+    bool success = old > 0 && session->m_session_counter.compare_exchange_strong(old, old - 1);
+#endif
+    if (success) {
+        SessionElement::ThreadSafeStruct& slot = stateful ? acquireNextSlot(*session) : acquireReadySlot(*session);
+        ANIRA_TRACE(Dequeue, session->sessionID, (unsigned int) slot.timeStamp);
+        inference(*session, slot);
+        ANIRA_TRACE(Done, session->sessionID, (unsigned int) slot.timeStamp);
+        if (stateful) {
+            session->stateLocked.store(false, std::memory_order_release);
+        }
+#ifdef USE_SEMAPHORE
+        slot.done.release();
+#else
+        slot.done.set();
+#endif
+        return true;
+    }
+    if (stateful) {
+        session->stateLocked.store(false, std::memory_order_release);
+    }
+    return false;
+}
+
+// Slots are marked ready before the session counter is raised, so taking the counter guarantees a ready slot
+SessionElement::ThreadSafeStruct& InferenceThread::acquireReadySlot(SessionElement& session) {
+    while (true) {
+        for (size_t i = 0; i < session.inferenceQueue.size(); ++i) {
+#ifdef USE_SEMAPHORE
+            if (session.inferenceQueue[i]->ready.try_acquire()) {
+#else
+            if (session.inferenceQueue[i]->ready.exchange(false)) {
+#endif
+                return *session.inferenceQueue[i];
             }
         }
     }
+}
+
+// Slots are submitted with consecutive time stamps and marked ready in that order, so the next one is ready whenever the session counter was taken.
+// Other ready slots are handed back, with stateLocked held no other thread takes slots of this session.
+SessionElement::ThreadSafeStruct& InferenceThread::acquireNextSlot(SessionElement& session) {
+    while (true) {
+        for (size_t i = 0; i < session.inferenceQueue.size(); ++i) {
+            SessionElement::ThreadSafeStruct& slot = *session.inferenceQueue[i];
+#ifdef USE_SEMAPHORE
+            if (slot.ready.try_acquire()) {
 #else
-    int old = session->m_session_counter.load();
-    if (old > 0) {
-        if (session->m_session_counter.compare_exchange_strong(old, old - 1)) {
-            while (true) {
-                for (size_t i = 0; i < session->inferenceQueue.size(); ++i) {
-                    if (session->inferenceQueue[i]->ready.exchange(false)) {
-                        inference(session, session->inferenceQueue[i]->processedModelInput, session->inferenceQueue[i]->rawModelOutput);
-                        session->inferenceQueue[i]->done.exchange(true);
-                        return true;
-                    }
+            if (slot.ready.exchange(false)) {
+#endif
+                if (slot.timeStamp == session.nextStatefulTimeStamp) {
+                    session.nextStatefulTimeStamp = session.nextStatefulTimeStamp >= UINT16_MAX ? 0 : session.nextStatefulTimeStamp + 1;
+                    return slot;
                 }
+#ifdef USE_SEMAPHORE
+                slot.ready.release();
+#else
+                slot.ready.exchange(true);
+#endif
             }
         }
     }
-#endif
-    return false;
 }
 
-void InferenceThread::inference(std::shared_ptr<SessionElement> session, AudioBufferF& input, AudioBufferF& output) {
+void InferenceThread::inference(SessionElement& session, SessionElement::ThreadSafeStruct& slot) {
+    ANIRA_TRACE(InferenceBegin, session.sessionID, (unsigned int) slot.timeStamp);
+    InferenceBackend backend = session.currentBackend.load();
+    bool stateful = session.inferenceConfig.m_stateful && !session.states[backend].empty();
+    auto start = std::chrono::steady_clock::now();
+    if (stateful) {
+        restoreState(session, slot, backend);
+    } else {
+        // The backend instance is about to change, whatever state it held
+        m_loaded_states[backend] = nullptr;
+    }
+    inference(session, slot.processedModelInput, slot.rawModelOutput);
+    if (stateful) {
+        saveState(session, slot, backend);
+    }
+    auto end = std::chrono::steady_clock::now();
+    ANIRA_TRACE(InferenceEnd, session.sessionID, (unsigned int) slot.timeStamp);
+
+    uint64_t inference_time = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    uint64_t queue_wait_time = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(start - slot.submitTime).count();
+    session.statistics.recordInference(inference_time, queue_wait_time);
+    slot.inferenceTime = inference_time;
+
+    m_busy_time.fetch_add(inference_time, std::memory_order_relaxed);
+    m_num_inferences.fetch_add(1, std::memory_order_relaxed);
+    // The thread cpu time can only be read on the thread itself
+    m_cpu_time.store(getCurrentThreadCpuTime(), std::memory_order_relaxed);
+}
+
+void InferenceThread::inference(SessionElement& session, AudioBufferF& input, AudioBufferF& output) {
 #ifdef USE_LIBTORCH
-    if (session->currentBackend == LIBTORCH) {
+    if (session.currentBackend == LIBTORCH) {
         torchProcessor.processBlock(input, output);
     }
 #endif
 #ifdef USE_ONNXRUNTIME
-    if (session->currentBackend == ONNX) {
+    if (session.currentBackend == ONNX) {
         onnxProcessor.processBlock(input, output);
     }
 #endif
 #ifdef USE_TFLITE
-    if (session->currentBackend == TFLITE) {
+    if (session.currentBackend == TFLITE) {
         tfliteProcessor.processBlock(input, output);
     }
 #endif
-    if (session->currentBackend == NONE) {
-        session->noneProcessor.processBlock(input, output);
+    if (session.currentBackend == NONE) {
+        session.noneProcessor.processBlock(input, output);
     }
 }
 
-} // namespace anira
\ No newline at end of file
+void InferenceThread::initializeState(SessionElement& session) {
+    size_t num_states = session.getNumSlotsPerRound();
+    for (size_t backend = 0; backend < session.states.size(); ++backend) {
+        session.states[backend].clear();
+        withBackend((InferenceBackend) backend, [&] (auto& processor) {
+            processor.resetState();
+            size_t state_size = processor.getStateSize();
+            session.states[backend].resize(num_states * state_size);
+            for (size_t i = 0; i < num_states; ++i) {
+                processor.saveState(session.states[backend].data() + i * state_size);
+            }
+        });
+        m_loaded_states[backend] = nullptr;
+    }
+    session.stateOwners.assign(num_states, nullptr);
+}
+
+void InferenceThread::restoreState(SessionElement& session, SessionElement::ThreadSafeStruct& slot, InferenceBackend backend) {
+    size_t state_size = session.states[backend].size() / session.stateOwners.size();
+    const float* state = session.states[backend].data() + slot.channel * state_size;
+    // Still in the backend if this thread ran the last inference of the channel and nothing else since
+    if (session.stateOwners[slot.channel] == this && m_loaded_states[backend] == state) {
+        return;
+    }
+    withBackend(backend, [&] (auto& processor) {
+        processor.restoreState(state);
+    });
+    m_loaded_states[backend] = state;
+}
+
+void InferenceThread::saveState(SessionElement& session, SessionElement::ThreadSafeStruct& slot, InferenceBackend backend) {
+    size_t state_size = session.states[backend].size() / session.stateOwners.size();
+    float* state = session.states[backend].data() + slot.channel * state_size;
+    withBackend(backend, [&] (auto& processor) {
+        processor.saveState(state);
+    });
+    session.stateOwners[slot.channel] = this;
+}
+
+template <typename Function>
+void InferenceThread::withBackend(InferenceBackend backend, Function&& function) {
+#ifdef USE_LIBTORCH
+    if (backend == LIBTORCH) {
+        function(torchProcessor);
+    }
+#endif
+    (void) backend;
+    (void) function;
+}
+
+WorkerStatistics InferenceThread::getStatistics() const {
+    WorkerStatistics statistics;
+    statistics.cpuTime = m_cpu_time.load(std::memory_order_relaxed);
+    statistics.busyTime = m_busy_time.load(std::memory_order_relaxed);
+    statistics.numInferences = m_num_inferences.load(std::memory_order_relaxed);
+    statistics.cpus = getAffinity();
+    return statistics;
+}
+
+} // namespace anira
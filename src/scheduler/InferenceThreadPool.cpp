@@ -1,12 +1,34 @@
 #include <anira/scheduler/InferenceThreadPool.h>
+#include <anira/utils/MemoryLock.h>
+#include <anira/utils/SimdKernels.h>
+#include <algorithm>
 
 namespace anira {
 
 InferenceThreadPool::InferenceThreadPool(InferenceConfig& config) {
+    deadlineScheduling = config.m_deadline_scheduling;
+    affinity = config.m_affinity;
+    affinityCpus = config.m_affinity_cpus;
+    callerCpu = CpuTopology::getCurrentCpu();
+    if (config.m_memory_lock == InferenceConfig::MemoryLockAll) {
+#if __linux__
+        if (!lockAllMemory()) {
+            reportMemoryLockFailure("the process memory", 0);
+        }
+#else
+#ifndef BELA
+        std::cout << "[WARNING] Locking all process memory is only supported on Linux, only the session buffers are locked" << std::endl;
+#else
+        printf("[WARNING] Locking all process memory is only supported on Linux, only the session buffers are locked\n");
+#endif
+#endif
+    }
     if (! config.m_bind_session_to_thread) {
         for (int i = 0; i < config.m_number_of_threads; ++i) {
             threadPool.emplace_back(std::make_unique<InferenceThread>(global_counter, config, sessions));
+            setInitPolicy(config);
         }
+        assignAffinity();
     }
 }
 
@@ -39,6 +61,8 @@ SessionElement& InferenceThreadPool::createSession(PrePostProcessor& prePostProc
 
     if (config.m_bind_session_to_thread) {
         threadPool.emplace_back(std::make_unique<InferenceThread>(global_counter, config, sessions, sessionID));
+        setInitPolicy(config);
+        assignAffinity();
     }
 
     for (size_t i = 0; i < (size_t) threadPool.size(); ++i) {
@@ -55,7 +79,7 @@ void InferenceThreadPool::releaseThreadPool() {
 void InferenceThreadPool::releaseSession(SessionElement& session, InferenceConfig& config) {
     activeSessions--;
 
-    if (config.m_bind_session_to_thread) {
+    if (session.boundToThread) {
         for (size_t i = 0; i < (size_t) threadPool.size(); ++i) {
             if (threadPool[i]->getSessionID() == session.sessionID) { // überlegen
                 threadPool[i]->stop();
@@ -73,6 +97,7 @@ void InferenceThreadPool::releaseSession(SessionElement& session, InferenceConfi
         }
     }
 
+    discardPendingInferences(session);
     for (size_t i = 0; i < sessions.size(); ++i) {
         if (sessions[i].get() == &session) {
             sessions.erase(sessions.begin() + (ptrdiff_t) i);
@@ -95,49 +120,110 @@ void InferenceThreadPool::prepare(SessionElement& session, HostAudioConfig newCo
         threadPool[i]->stop();
     }
 
+    discardPendingInferences(session);
     session.clear();
     session.prepare(newConfig);
+    // All threads load the same model, so any of them can provide the initial state
+    if (session.inferenceConfig.m_stateful && !threadPool.empty()) {
+        threadPool.front()->initializeState(session);
+        bindStatelessSession(session);
+    }
 
-#ifdef USE_SEMAPHORE
-    while (global_counter.try_acquire()) {
-        // Nothing to do here, just reducing count
+    for (size_t i = 0; i < (size_t) threadPool.size(); ++i) {
+        threadPool[i]->start();
     }
+}
+
+std::vector<float> InferenceThreadPool::measureInferenceTimes(SessionElement& session, InferenceBackend backend, size_t numInferences) {
+    std::vector<float> inference_times;
+    InferenceBackend previous_backend = session.currentBackend.exchange(backend);
+    auto timeout = std::chrono::seconds(10);
+
+    // Enough silence for every pre processor, leftovers are cleared by the next prepare. With parallel channels only the first channel is timed, the others run the same model.
+    size_t num_samples = (size_t) std::max(session.inferenceConfig.m_new_model_input_size, session.inferenceConfig.m_new_model_output_size);
+
+    for (size_t i = 0; i < numInferences; ++i) {
+        for (size_t channel = 0; channel < session.numChannels; ++channel) {
+            for (size_t j = 0; j < num_samples; ++j) {
+                session.sendBuffer.pushSample(channel, 0.f);
+            }
+        }
+        if (!preProcess(session, 0)) {
+            break;
+        }
+        SessionElement::ThreadSafeStruct* slot = nullptr;
+        for (auto& queue_element : session.inferenceQueue) {
+            if (queue_element->timeStamp == session.timeStamps.back()) {
+                slot = queue_element.get();
+                break;
+            }
+        }
+
+        bool done = false;
+        auto start = std::chrono::steady_clock::now();
+        while (!done && std::chrono::steady_clock::now() - start < timeout) {
+#ifdef USE_SEMAPHORE
+            done = slot->done.try_acquire_for(std::chrono::milliseconds(1));
+#else
+            done = slot->done.consumeUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(1));
+#endif
+        }
+        if (!done) {
+#ifndef BELA
+            std::cout << "[WARNING] Calibration of backend " << getInferenceBackendName(backend) << " stopped, an inference did not finish within " << timeout.count() << " s" << std::endl;
 #else
-    global_counter.store(0);
+            printf("[WARNING] Calibration of backend %s stopped, an inference did not finish within %lld s\n", getInferenceBackendName(backend), (long long) timeout.count());
 #endif
+            break;
+        }
 
-    for (size_t i = 0; i < (size_t) threadPool.size(); ++i) {
-        threadPool[i]->start();
+        session.timeStamps.pop_back();
+        postProcess(session, *slot);
+        for (size_t channel = 0; channel < session.numChannels; ++channel) {
+            session.receiveBuffer.discardSamples(channel, session.receiveBuffer.getAvailableSamples(channel));
+        }
+        inference_times.push_back((float) slot->inferenceTime * 1e-6f);
     }
+
+    session.currentBackend.store(previous_backend);
+    return inference_times;
 }
 
 void InferenceThreadPool::newDataSubmitted(SessionElement& session) {
     // We assume that the model_output_size gives us the amount of new samples that we need to process. This can differ from the model_input_size because we might need to add some padding or past samples.
-    while (session.sendBuffer.getAvailableSamples(0) >= (session.inferenceConfig.m_new_model_output_size)) {
-        bool success = preProcess(session);
-        // !success means that there is no free inferenceQueue
-        if (!success) {
-            for (size_t i = 0; i < session.inferenceConfig.m_new_model_output_size; ++i) {
-                session.sendBuffer.popSample(0);
-                session.receiveBuffer.pushSample(0, 0.f);
+    // All channels are pushed with the same number of samples, so the first one tells how many rounds are ready
+    while (session.sendBuffer.getAvailableSamples(0) >= session.numNewSamples) {
+        if (skipSilentRound(session)) {
+            continue;
+        }
+        for (size_t channel = 0; channel < session.getNumSlotsPerRound(); ++channel) {
+            bool success = preProcess(session, channel);
+            // !success means that there is no free inferenceQueue
+            if (!success) {
+                skipInference(session, channel);
+                session.statistics.recordDroppedInference();
             }
         }
     }
 }
 
 void InferenceThreadPool::newDataRequest(SessionElement& session, double bufferSizeInSec) {
-#ifdef USE_SEMAPHORE
     auto timeToProcess = std::chrono::microseconds(static_cast<long>(bufferSizeInSec * 1e6 * session.inferenceConfig.m_wait_in_process_block));
-    auto currentTime = std::chrono::system_clock::now();
-    auto waitUntil = currentTime + timeToProcess;
+#ifdef USE_SEMAPHORE
+    auto waitUntil = std::chrono::system_clock::now() + timeToProcess;
+#else
+    auto waitUntil = std::chrono::steady_clock::now() + timeToProcess;
 #endif
     while (session.timeStamps.size() > 0) {
+        if (emitSilentRounds(session)) {
+            continue;
+        }
         for (size_t i = 0; i < session.inferenceQueue.size(); ++i) {
             if (session.inferenceQueue[i]->timeStamp == session.timeStamps.back()) {
 #ifdef USE_SEMAPHORE
                 if (session.inferenceQueue[i]->done.try_acquire_until(waitUntil)) {
 #else
-                if (session.inferenceQueue[i]->done.exchange(false)) {
+                if (session.inferenceQueue[i]->done.consumeUntil(waitUntil)) {
 #endif
                     session.timeStamps.pop_back();
                     postProcess(session, *session.inferenceQueue[i]);
@@ -150,48 +236,472 @@ void InferenceThreadPool::newDataRequest(SessionElement& session, double bufferS
     }
 }
 
-std::vector<std::shared_ptr<SessionElement>>& InferenceThreadPool::getSessions() {
-    return sessions;
+void InferenceThreadPool::newDataSubmittedBlocking(SessionElement& session) {
+    // Every window is submitted at once, so the inference threads work on them in parallel
+    while (session.sendBuffer.getAvailableSamples(0) >= session.numNewSamples) {
+        if (skipSilentRound(session)) {
+            continue;
+        }
+        for (size_t channel = 0; channel < session.getNumSlotsPerRound(); ++channel) {
+            if (session.timeStamps.size() >= session.numThreadSlots) {
+                collectOldest(session);
+            }
+            preProcess(session, channel);
+        }
+    }
+}
+
+void InferenceThreadPool::newDataRequestBlocking(SessionElement& session, size_t numSamples) {
+    // Parallel channels are collected one after another, so a channel can be ahead of the others
+    while (session.receiveBuffer.getMinAvailableSamples() < numSamples) {
+        if (!collectOldest(session)) {
+            break;
+        }
+    }
 }
 
-bool InferenceThreadPool::preProcess(SessionElement& session) {
+bool InferenceThreadPool::collectOldest(SessionElement& session) {
+    if (session.timeStamps.empty()) {
+        return false;
+    }
+    if (emitSilentRounds(session)) {
+        return true;
+    }
     for (size_t i = 0; i < session.inferenceQueue.size(); ++i) {
+        if (session.inferenceQueue[i]->timeStamp == session.timeStamps.back()) {
 #ifdef USE_SEMAPHORE
-        if (session.inferenceQueue[i]->free.try_acquire()) {
+            session.inferenceQueue[i]->done.acquire();
 #else
-        if (session.inferenceQueue[i]->free.exchange(false)) {
+            session.inferenceQueue[i]->done.consume();
+#endif
+            session.timeStamps.pop_back();
+            postProcess(session, *session.inferenceQueue[i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+void InferenceThreadPool::newDataProcessedSynchronous(SessionElement& session, InferenceThread& worker) {
+    while (session.sendBuffer.getAvailableSamples(0) >= session.numNewSamples) {
+        if (skipSilentRound(session)) {
+            continue;
+        }
+        for (size_t channel = 0; channel < session.getNumSlotsPerRound(); ++channel) {
+            // Every slot is collected right after its inference, so the first one is normally free. A busy one is dropped like a full queue, the audio thread must not wait.
+            SessionElement::ThreadSafeStruct& slot = *session.inferenceQueue.front();
+#ifdef USE_SEMAPHORE
+            if (!slot.free.try_acquire()) {
+#else
+            if (!slot.free.exchange(false)) {
+#endif
+                skipInference(session, channel);
+                session.statistics.recordDroppedInference();
+                continue;
+            }
+            session.statistics.slotSubmitted();
+            fillSlot(session, slot, channel);
+            slot.submitTime = std::chrono::steady_clock::now();
+            worker.processSlot(session, slot);
+#ifdef USE_SEMAPHORE
+            slot.done.release();
+#else
+            slot.done.set();
 #endif
-            session.prePostProcessor.preProcess(session.sendBuffer, session.inferenceQueue[i]->processedModelInput, session.currentBackend.load());
+            // Rounds skipped by the silence gate are collected before the slot
+            while (collectOldest(session)) {}
+        }
+    }
+}
+
+void InferenceThreadPool::newDataRequestAssisted(SessionElement& session, InferenceThread& worker, size_t numSamples) {
+    // The backend of the audio thread does not hold the hidden state of a bound session
+    if (session.boundToThread) {
+        return;
+    }
+    while (session.receiveBuffer.getMinAvailableSamples() < numSamples && !session.timeStamps.empty()) {
+        if (emitSilentRounds(session)) {
+            continue;
+        }
+        SessionElement::ThreadSafeStruct* oldest = nullptr;
+        for (auto& slot : session.inferenceQueue) {
+            if (slot->timeStamp == session.timeStamps.back()) {
+                oldest = slot.get();
+                break;
+            }
+        }
+        // Once an inference thread runs the slot, waiting for it any longer would miss the deadline anyway
+        if (oldest == nullptr || !claimSlot(session, *oldest)) {
+            return;
+        }
+        worker.processSlot(session, *oldest);
+        if (session.inferenceConfig.m_stateful) {
+            session.stateLocked.store(false, std::memory_order_release);
+        }
+        session.statistics.recordAssistedInference();
+        session.timeStamps.pop_back();
+        postProcess(session, *oldest);
+    }
+}
 
-            session.timeStamps.insert(session.timeStamps.begin(), session.m_current_queue);
-            session.inferenceQueue[i]->timeStamp = session.m_current_queue;
+bool InferenceThreadPool::claimSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot) {
+    // Stateful slots run in order, the state lock keeps the inference threads from starting the next one meanwhile. It stays taken on success until the slot ran.
+    bool stateful = session.inferenceConfig.m_stateful;
+    if (stateful && session.stateLocked.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+    // Same order as the inference threads: the global job, the job of the session, then the slot
+#ifdef USE_SEMAPHORE
+    bool success = global_counter.try_acquire();
+    if (success && !session.m_session_counter.try_acquire()) {
+        global_counter.release();
+        success = false;
+    }
+#else
+    int old = global_counter.load();
+    bool success = old > 0 && global_counter.compare_exchange_strong(old, old - 1);
+    if (success) {
+        old = session.m_session_counter.load();
+        if (!(old > 0 && session.m_session_counter.compare_exchange_strong(old, old - 1))) {
+            global_counter.fetch_add(1);
+            success = false;
+        }
+    }
+#endif
+    if (success) {
+        bool claimed = false;
+        if (!stateful || slot.timeStamp == session.nextStatefulTimeStamp) {
+#ifdef USE_SEMAPHORE
+            claimed = slot.ready.try_acquire();
+#else
+            claimed = slot.ready.exchange(false);
+#endif
+        }
+        if (!claimed) {
+            // Some other slot is still ready for the jobs
 #ifdef USE_SEMAPHORE
-            session.inferenceQueue[i]->ready.release();
             session.m_session_counter.release();
             global_counter.release();
 #else
-            session.inferenceQueue[i]->ready.exchange(true);
             session.m_session_counter.fetch_add(1);
             global_counter.fetch_add(1);
 #endif
-            if (session.m_current_queue >= UINT16_MAX) {
-                session.m_current_queue = 0;
-            } else {
-                session.m_current_queue++;
+            success = false;
+        }
+    }
+    if (success && stateful) {
+        session.nextStatefulTimeStamp = session.nextStatefulTimeStamp >= UINT16_MAX ? 0 : session.nextStatefulTimeStamp + 1;
+    }
+    if (!success && stateful) {
+        session.stateLocked.store(false, std::memory_order_release);
+    }
+    return success;
+}
+
+void InferenceThreadPool::bindStatelessSession(SessionElement& session) {
+    InferenceConfig& config = session.inferenceConfig;
+    if (session.boundToThread) {
+        // Bound by the config or an earlier prepare, the thread of the session starts from the initial state as well
+        for (auto& thread : threadPool) {
+            if (thread->getSessionID() == session.sessionID) {
+                thread->initializeState(session);
             }
-            return true;
         }
+        return;
     }
+    for (size_t backend = 0; backend < session.states.size(); ++backend) {
+        if (backend == NONE || config.getModelPath((InferenceBackend) backend).empty() || !session.states[backend].empty()) {
+            continue;
+        }
+        // The hidden state stays in the backend instance of every thread, so the inferences of the session must not move between threads
 #ifndef BELA
-    std::cout << "[WARNING] No free inferenceQueue found!" << std::endl;
+        std::cout << "[WARNING] The backend " << getInferenceBackendName((InferenceBackend) backend) << " can not save the state of stateful models, session " << session.sessionID << " is bound to its own inference thread" << std::endl;
 #else
-    printf("[WARNING] No free inferenceQueue found!\n");
+        printf("[WARNING] The backend %s can not save the state of stateful models, session %d is bound to its own inference thread\n", getInferenceBackendName((InferenceBackend) backend), session.sessionID);
 #endif
-    return false;
+        session.boundToThread = true;
+        threadPool.emplace_back(std::make_unique<InferenceThread>(global_counter, config, sessions, session.sessionID));
+        setInitPolicy(config);
+        assignAffinity();
+        threadPool.back()->initializeState(session);
+        return;
+    }
+}
+
+void InferenceThreadPool::discardPendingInferences(SessionElement& session) {
+#ifdef USE_SEMAPHORE
+    while (session.m_session_counter.try_acquire()) {
+        global_counter.try_acquire();
+    }
+#else
+    global_counter.fetch_sub(session.m_session_counter.exchange(0));
+#endif
+}
+
+std::vector<std::shared_ptr<SessionElement>>& InferenceThreadPool::getSessions() {
+    return sessions;
+}
+
+bool InferenceThreadPool::preProcess(SessionElement& session, size_t channel) {
+    for (size_t i = 0; i < session.numThreadSlots; ++i) {
+#ifdef USE_SEMAPHORE
+        if (session.inferenceQueue[i]->free.try_acquire()) {
+#else
+        if (session.inferenceQueue[i]->free.exchange(false)) {
+#endif
+            if (i >= session.numThreadSlots - session.numReserveSlots) {
+                session.statistics.recordReserveSlotUsed();
+            }
+            session.statistics.slotSubmitted();
+            fillSlot(session, *session.inferenceQueue[i], channel);
+            submitSlot(session, *session.inferenceQueue[i], true);
+            return true;
+        }
+    }
+    session.statistics.recordQueueFull();
+    session.telemetry.record<TelemetryEventType::QueueFull>(session.sessionID, (int64_t) session.numNewSamples);
+
+    switch (session.inferenceConfig.m_overflow_policy) {
+        case InferenceConfig::OverflowDropOldest:
+            return dropOldestInference(session, channel);
+        case InferenceConfig::OverflowFallback:
+            return processInline(session, channel);
+        default:
+            return false;
+    }
+}
+
+void InferenceThreadPool::fillSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot, size_t channel) {
+    ANIRA_TRACE(PreProcessBegin, session.sessionID, (unsigned int) session.m_current_queue);
+    if (session.channelParallel) {
+        session.prePostProcessor.preProcessChannel(session.sendBuffer, slot.processedModelInput, channel, session.currentBackend.load());
+    } else {
+        session.prePostProcessor.preProcess(session.sendBuffer, slot.processedModelInput, session.currentBackend.load());
+    }
+    slot.channel = channel;
+    slot.silentInput = session.silentSamples >= session.silenceInputSamples;
+
+    session.timeStamps.insert(session.timeStamps.begin(), session.m_current_queue);
+    slot.timeStamp = session.m_current_queue;
+    if (session.m_current_queue >= UINT16_MAX) {
+        session.m_current_queue = 0;
+    } else {
+        session.m_current_queue++;
+    }
+}
+
+void InferenceThreadPool::submitSlot(SessionElement& session, SessionElement::ThreadSafeStruct& slot, bool newJob) {
+    slot.submitTime = std::chrono::steady_clock::now();
+    ANIRA_TRACE(Submit, session.sessionID, (unsigned int) slot.timeStamp);
+#ifdef USE_SEMAPHORE
+    slot.ready.release();
+    session.m_session_counter.release();
+    if (newJob) {
+        global_counter.release();
+    }
+#else
+    slot.ready.exchange(true);
+    session.m_session_counter.fetch_add(1);
+    if (newJob) {
+        global_counter.fetch_add(1);
+    }
+#endif
+}
+
+SessionElement::ThreadSafeStruct* InferenceThreadPool::acquireOverflowSlot(SessionElement& session) {
+    for (size_t i = session.numThreadSlots; i < session.inferenceQueue.size(); ++i) {
+#ifdef USE_SEMAPHORE
+        if (session.inferenceQueue[i]->free.try_acquire()) {
+#else
+        if (session.inferenceQueue[i]->free.exchange(false)) {
+#endif
+            return session.inferenceQueue[i].get();
+        }
+    }
+    return nullptr;
+}
+
+bool InferenceThreadPool::dropOldestInference(SessionElement& session, size_t channel) {
+    if (session.inferenceConfig.m_stateful) {
+        return false;
+    }
+    SessionElement::ThreadSafeStruct* placeholder = acquireOverflowSlot(session);
+    if (placeholder == nullptr) {
+        return false;
+    }
+    // Taking a job of the session guarantees that a ready slot is left that no inference thread will pick up
+#ifdef USE_SEMAPHORE
+    bool success = session.m_session_counter.try_acquire();
+#else
+    int old = session.m_session_counter.load();
+    bool success = old > 0 && session.m_session_counter.compare_exchange_strong(old, old - 1);
+#endif
+    SessionElement::ThreadSafeStruct* oldest = nullptr;
+    // One pass over the time stamps, which are ordered newest first. The workers race for the same slots, so the oldest one may be gone by the time it is reached.
+    for (auto time_stamp = session.timeStamps.rbegin(); success && time_stamp != session.timeStamps.rend() && oldest == nullptr; ++time_stamp) {
+        for (size_t i = 0; i < session.numThreadSlots; ++i) {
+            SessionElement::ThreadSafeStruct& slot = *session.inferenceQueue[i];
+            if (slot.timeStamp != *time_stamp) {
+                continue;
+            }
+#ifdef USE_SEMAPHORE
+            if (slot.ready.try_acquire()) {
+#else
+            if (slot.ready.exchange(false)) {
+#endif
+                oldest = &slot;
+            }
+            break;
+        }
+    }
+    if (oldest == nullptr) {
+        // The workers took every waiting slot meanwhile, the new window is dropped instead
+        if (success) {
+#ifdef USE_SEMAPHORE
+            session.m_session_counter.release();
+#else
+            session.m_session_counter.fetch_add(1);
+#endif
+        }
+#ifdef USE_SEMAPHORE
+        placeholder->free.release();
+#else
+        placeholder->free.exchange(true);
+#endif
+        return false;
+    }
+
+    // The placeholder takes the place of the dropped window in the output and is collected as silence
+    placeholder->timeStamp = oldest->timeStamp;
+    placeholder->channel = oldest->channel;
+    placeholder->silentInput = false;
+    placeholder->rawModelOutput.clear();
+    session.statistics.slotSubmitted();
+#ifdef USE_SEMAPHORE
+    placeholder->done.release();
+#else
+    placeholder->done.set();
+#endif
+    session.statistics.recordDroppedInference();
+
+    // The slot is handed back with the new window, the job taken above stays in the global counter
+    fillSlot(session, *oldest, channel);
+    submitSlot(session, *oldest, false);
+    return true;
+}
+
+bool InferenceThreadPool::processInline(SessionElement& session, size_t channel) {
+    // The window would take a time stamp that no inference thread ever runs, the next stateful inference would wait for it forever
+    if (session.inferenceConfig.m_stateful) {
+        return false;
+    }
+    SessionElement::ThreadSafeStruct* slot = acquireOverflowSlot(session);
+    if (slot == nullptr) {
+        return false;
+    }
+    session.statistics.slotSubmitted();
+    fillSlot(session, *slot, channel);
+    // The bypass output is no response of the model to silence
+    slot->silentInput = false;
+    session.noneProcessor.processBlock(slot->processedModelInput, slot->rawModelOutput);
+    session.statistics.recordInlineFallback();
+#ifdef USE_SEMAPHORE
+    slot->done.release();
+#else
+    slot->done.set();
+#endif
+    return true;
+}
+
+void InferenceThreadPool::skipInference(SessionElement& session, size_t channel) {
+    if (session.channelParallel) {
+        session.prePostProcessor.skipChannelSamples(session.sendBuffer, channel, session.numNewSamples, session.currentBackend.load());
+    } else {
+        session.prePostProcessor.skipSamples(session.sendBuffer, session.numNewSamples, session.currentBackend.load());
+    }
+    outputSilence(session, channel);
+}
+
+void InferenceThreadPool::outputSilence(SessionElement& session, size_t channel) {
+    for (size_t c = 0; c < session.numChannels; ++c) {
+        if (session.channelParallel && c != channel) {
+            continue;
+        }
+        for (size_t i = 0; i < session.numNewSamples; ++i) {
+            session.receiveBuffer.pushSample(c, 0.f);
+        }
+    }
+}
+
+bool InferenceThreadPool::skipSilentRound(SessionElement& session) {
+    if (!session.inferenceConfig.m_silence_gate) {
+        return false;
+    }
+    float peak = 0.f;
+    for (size_t channel = 0; channel < session.numChannels; ++channel) {
+        peak = std::max(peak, session.sendBuffer.getPeak(channel, session.numNewSamples));
+    }
+    if (peak > session.inferenceConfig.m_silence_threshold) {
+        session.silentSamples = 0;
+        return false;
+    }
+    session.silentSamples = std::min(session.silentSamples + session.numNewSamples, session.silenceGateSamples);
+    if (session.silentSamples < session.silenceGateSamples) {
+        return false;
+    }
+
+    // The pre processor still sees the samples, so its history is right when the signal returns
+    for (size_t channel = 0; channel < session.getNumSlotsPerRound(); ++channel) {
+        if (session.channelParallel) {
+            session.prePostProcessor.skipChannelSamples(session.sendBuffer, channel, session.numNewSamples, session.currentBackend.load());
+        } else {
+            session.prePostProcessor.skipSamples(session.sendBuffer, session.numNewSamples, session.currentBackend.load());
+        }
+    }
+    // Consecutive skipped rounds share one time stamp, so the queue of time stamps never grows during silence
+    if (!session.timeStamps.empty() && (session.timeStamps.front() & SessionElement::SILENT_ROUNDS)) {
+        session.timeStamps.front()++;
+    } else {
+        session.timeStamps.insert(session.timeStamps.begin(), SessionElement::SILENT_ROUNDS | 1);
+    }
+    session.statistics.recordSilentInferences(session.getNumSlotsPerRound());
+    return true;
+}
+
+bool InferenceThreadPool::emitSilentRounds(SessionElement& session) {
+    if (!(session.timeStamps.back() & SessionElement::SILENT_ROUNDS)) {
+        return false;
+    }
+    unsigned long rounds = session.timeStamps.back() & ~SessionElement::SILENT_ROUNDS;
+    session.timeStamps.pop_back();
+    for (unsigned long round = 0; round < rounds; ++round) {
+        for (size_t channel = 0; channel < session.getNumSlotsPerRound(); ++channel) {
+            if (!session.hasSilenceResponse[channel]) {
+                outputSilence(session, channel);
+            } else if (session.channelParallel) {
+                session.prePostProcessor.postProcessChannel(session.silenceResponses[channel], session.receiveBuffer, channel, session.currentBackend.load());
+            } else {
+                session.prePostProcessor.postProcess(session.silenceResponses[channel], session.receiveBuffer, session.currentBackend.load());
+            }
+        }
+    }
+    return true;
 }
 
 void InferenceThreadPool::postProcess(SessionElement& session, SessionElement::ThreadSafeStruct& nextBuffer) {
-    session.prePostProcessor.postProcess(nextBuffer.rawModelOutput, session.receiveBuffer, session.currentBackend.load());
+    ANIRA_TRACE(PostProcessBegin, session.sessionID, (unsigned int) nextBuffer.timeStamp);
+    if (session.channelParallel) {
+        session.prePostProcessor.postProcessChannel(nextBuffer.rawModelOutput, session.receiveBuffer, nextBuffer.channel, session.currentBackend.load());
+    } else {
+        session.prePostProcessor.postProcess(nextBuffer.rawModelOutput, session.receiveBuffer, session.currentBackend.load());
+    }
+    if (nextBuffer.silentInput && session.inferenceConfig.m_silence_gate) {
+        size_t index = session.channelParallel ? nextBuffer.channel : 0;
+        simd::copy(session.silenceResponses[index].getWritePointer(0), nextBuffer.rawModelOutput.getReadPointer(0), nextBuffer.rawModelOutput.getNumSamples());
+        session.hasSilenceResponse[index] = true;
+    }
+    session.statistics.slotCollected();
+    ANIRA_TRACE(Collect, session.sessionID, (unsigned int) nextBuffer.timeStamp);
 #ifdef USE_SEMAPHORE
     nextBuffer.free.release();
 #else
@@ -199,6 +709,111 @@ void InferenceThreadPool::postProcess(SessionElement& session, SessionElement::T
 #endif
 }
 
+std::vector<WorkerStatistics> InferenceThreadPool::getWorkerStatistics() {
+    std::vector<WorkerStatistics> statistics;
+    for (const auto& thread : threadPool) {
+        statistics.push_back(thread->getStatistics());
+    }
+    return statistics;
+}
+
+void InferenceThreadPool::setInitPolicy(InferenceConfig& config) {
+    int index = (int) threadPool.size() - 1;
+    ThreadInitPolicy policy;
+    policy.name = "anira-worker-" + std::to_string(index);
+    policy.flushDenormals = config.m_flush_denormals;
+    policy.stackPrefaultSize = config.m_thread_stack_prefault;
+    if (config.m_thread_init) {
+        policy.hook = [hook = config.m_thread_init, index] { hook(index); };
+    }
+    threadPool.back()->setInitPolicy(policy);
+}
+
+void InferenceThreadPool::assignAffinity() {
+    if (affinity == InferenceConfig::AffinityNone && affinityCpus.empty()) {
+        return;
+    }
+    CpuTopology topology = CpuTopology::detect();
+    std::vector<std::vector<int>> cpus = topology.selectCpus(affinity, affinityCpus, callerCpu, threadPool.size());
+    for (size_t i = 0; i < threadPool.size(); ++i) {
+        threadPool[i]->setAffinity(cpus[i]);
+        if (cpus[i].empty()) {
+#ifndef BELA
+            std::cout << "[WARNING] None of the cpus of the affinity settings is available, inference thread " << i << " is not pinned" << std::endl;
+#else
+            printf("[WARNING] None of the cpus of the affinity settings is available, inference thread %zu is not pinned\n", i);
+#endif
+            continue;
+        }
+        std::string cpu_list;
+        for (int cpu : cpus[i]) {
+            cpu_list += (cpu_list.empty() ? "" : ",") + std::to_string(cpu);
+        }
+#ifndef BELA
+        std::cout << "[INFO] Inference thread " << i << " runs on cpus " << cpu_list << std::endl;
+#else
+        printf("[INFO] Inference thread %zu runs on cpus %s\n", i, cpu_list.c_str());
+#endif
+    }
+}
+
+void InferenceThreadPool::updateDeadlineScheduling() {
+    if (!deadlineScheduling) {
+        return;
+    }
+    size_t num_shared_threads = 0;
+    for (const auto& thread : threadPool) {
+        if (thread->getSessionID() < 0) {
+            num_shared_threads++;
+        }
+    }
+
+    size_t num_reserved = 0;
+    for (const auto& thread : threadPool) {
+        // Cpu time the served sessions need per ms in cores, the shortest host period and the tightest inference deadline in ms
+        double utilization = 0.;
+        double period = 0.;
+        double deadline = 0.;
+        for (const auto& session : sessions) {
+            bool served = thread->getSessionID() < 0 ? !session->boundToThread : thread->getSessionID() == session->sessionID;
+            if (!served || session->hostConfig.hostBufferSize == 0) {
+                continue;
+            }
+            double max_inference_time = session->maxInferenceTimes[session->currentBackend.load()];
+            utilization += (double) session->getNumSlotsPerRound() * max_inference_time * session->hostConfig.hostSampleRate / ((double) session->numNewSamples * 1000.);
+            double host_period = (double) session->hostConfig.hostBufferSize * 1000. / session->hostConfig.hostSampleRate;
+            period = period == 0. ? host_period : std::min(period, host_period);
+            if (session->inferenceDeadline > 0.f) {
+                deadline = deadline == 0. ? session->inferenceDeadline : std::min(deadline, (double) session->inferenceDeadline);
+            }
+        }
+        if (period == 0.) {
+            continue;
+        }
+        if (thread->getSessionID() < 0) {
+            utilization /= (double) num_shared_threads;
+        }
+        // At least 5 % of the period, so that an idle thread still gets to poll for new work
+        double runtime = std::clamp(utilization * period * DEADLINE_RUNTIME_HEADROOM, 0.05 * period, period);
+        deadline = deadline == 0. ? period : std::clamp(deadline, runtime, period);
+        if (thread->setDeadlineScheduling((uint64_t) (runtime * 1e6), (uint64_t) (deadline * 1e6), (uint64_t) (period * 1e6))) {
+            num_reserved++;
+        }
+#ifndef BELA
+        std::cout << "[INFO] SCHED_DEADLINE for inference thread: runtime " << runtime << " ms, deadline " << deadline << " ms, period " << period << " ms" << std::endl;
+#else
+        printf("[INFO] SCHED_DEADLINE for inference thread: runtime %f ms, deadline %f ms, period %f ms\n", runtime, deadline, period);
+#endif
+    }
+    if (num_reserved < threadPool.size()) {
+#ifndef BELA
+        std::cout << "[WARNING] " << threadPool.size() - num_reserved << " of " << threadPool.size() << " inference threads could not use SCHED_DEADLINE and stay on SCHED_FIFO" << std::endl;
+#else
+        printf("[WARNING] %zu of %zu inference threads could not use SCHED_DEADLINE and stay on SCHED_FIFO\n", threadPool.size() - num_reserved, threadPool.size());
+#endif
+    }
+}
+
 int InferenceThreadPool::getNumberOfSessions() {
     return activeSessions.load();
 }
@@ -1,17 +1,24 @@
 #include <anira/scheduler/SessionElement.h>
+#include <anira/utils/MemoryLock.h>
+#include <stdexcept>
 
 namespace anira {
 
 SessionElement::SessionElement(int newSessionID, PrePostProcessor& ppP, InferenceConfig& config, BackendBase& noneProcessor) :
+    boundToThread(config.m_bind_session_to_thread),
     sessionID(newSessionID),
     prePostProcessor(ppP),
     inferenceConfig(config),
     noneProcessor(noneProcessor)
 {
+    maxInferenceTimes.fill(config.m_max_inference_time);
 }
 
     SessionElement::ThreadSafeStruct::ThreadSafeStruct(size_t model_input_size,
-                                                       size_t model_output_size) {
+                                                       size_t model_output_size,
+                                                       MemoryAllocator& allocator) {
+        processedModelInput.setAllocator(allocator);
+        rawModelOutput.setAllocator(allocator);
         processedModelInput.initialize(1, model_input_size);
         rawModelOutput.initialize(1, model_output_size);
     }
@@ -30,17 +37,35 @@ SessionElement::SessionElement(int newSessionID, PrePostProcessor& ppP, Inferenc
 
         timeStamps.clear();
         inferenceQueue.clear();
+
+        nextStatefulTimeStamp = m_current_queue;
+        for (auto& state : states) {
+            state.clear();
+        }
+        stateOwners.clear();
+
+        silentSamples = 0;
+        hasSilenceResponse.assign(hasSilenceResponse.size(), false);
     }
 
     void SessionElement::prepare(HostAudioConfig newConfig) {
-        sendBuffer.initializeWithPositions(1, (size_t) newConfig.hostSampleRate * 50); // TODO find appropriate size dynamically
-        receiveBuffer.initializeWithPositions(1, (size_t) newConfig.hostSampleRate * 50); // TODO find appropriate size dynamically
+        hostConfig = newConfig;
+        numChannels = std::max<size_t>(newConfig.hostChannels, 1);
+        channelParallel = numChannels > 1 && inferenceConfig.m_channel_mode == InferenceConfig::ChannelParallel;
+        numNewSamples = (size_t) inferenceConfig.m_new_model_output_size;
+        if (numChannels > 1 && inferenceConfig.m_channel_mode == InferenceConfig::ChannelBatched) {
+            if (numNewSamples % numChannels != 0 || inferenceConfig.m_new_model_input_size % numChannels != 0) {
+                throw std::runtime_error("With batched channels the model input and output sizes must split evenly across the host channels");
+            }
+            numNewSamples /= numChannels;
+        }
 
-        size_t max_inference_time_in_samples = (size_t) std::ceil(inferenceConfig.m_max_inference_time * newConfig.hostSampleRate / 1000);
+        float max_inference_time = *std::max_element(maxInferenceTimes.begin(), maxInferenceTimes.end());
+        size_t max_inference_time_in_samples = (size_t) std::ceil(max_inference_time * newConfig.hostSampleRate / 1000);
 
         // We assume that the model_output_size gives us the amount of new samples we can write into the buffer for each bath.
-        float structs_per_buffer = std::ceil((float) newConfig.hostBufferSize / (float) inferenceConfig.m_new_model_output_size);
-        float structs_per_max_inference_time = std::ceil((float) max_inference_time_in_samples / (float) inferenceConfig.m_new_model_output_size);
+        float structs_per_buffer = std::ceil((float) newConfig.hostBufferSize / (float) numNewSamples);
+        float structs_per_max_inference_time = std::ceil((float) max_inference_time_in_samples / (float) numNewSamples);
         // ceil to full buffers
         structs_per_max_inference_time = std::ceil(structs_per_max_inference_time/structs_per_buffer) * structs_per_buffer;
         // we can have multiple max_inference_times per buffer
@@ -51,14 +76,75 @@ SessionElement::SessionElement(int newSessionID, PrePostProcessor& ppP, Inferenc
         // because each struct can take max_inference_time time to process and be free again
         int n_structs = (int) (structs_per_buffer + structs_per_max_inference_time * std::ceil(structs_per_buffer/max_inference_times_per_buffer));
 
-        // factor 4 to encounter the case where we have missing samples because the max_inference_time was calculated not correctly
-        n_structs *= 1; // TODO: before deployment we have to change this to 4
+        // With variable block sizes a full buffer of inferences can be submitted while the previous one is still in flight
+        if (newConfig.variableBufferSize) {
+            n_structs += (int) structs_per_buffer;
+        }
+        // Margin for the case that the max_inference_time was estimated too low
+        int n_reserve_structs = (int) structs_per_buffer * std::max(inferenceConfig.m_reserve_buffers, 0);
+        n_structs += n_reserve_structs;
+        // One buffer of windows can be handled on the audio thread when everything else is in use
+        int n_overflow_structs = inferenceConfig.m_overflow_policy != InferenceConfig::OverflowDropNewest ? (int) structs_per_buffer : 0;
+        // Parallel channels take one slot per channel and round
+        n_structs *= (int) getNumSlotsPerRound();
+        n_reserve_structs *= (int) getNumSlotsPerRound();
+        n_overflow_structs *= (int) getNumSlotsPerRound();
+        numThreadSlots = (size_t) n_structs;
+        numReserveSlots = (size_t) n_reserve_structs;
+        n_structs += n_overflow_structs;
+
+        // Upper bound of InferenceManager::calculateLatency for every backend: the buffer adaptation, whole host buffers for the inferences of one buffer and the model latency.
+        // The adaptive latency gets one more second to grow into.
+        size_t inferences_per_buffer = (size_t) structs_per_buffer * getNumSlotsPerRound();
+        size_t inference_latency = ((inferences_per_buffer * max_inference_time_in_samples + newConfig.hostBufferSize - 1) / newConfig.hostBufferSize + 1) * newConfig.hostBufferSize;
+        maxLatency = numNewSamples + inference_latency + (size_t) std::max(inferenceConfig.m_model_latency, 0);
+        if (inferenceConfig.m_adaptive_latency) {
+            maxLatency += (size_t) newConfig.hostSampleRate;
+        }
+        // The receive buffer holds the latency and the outputs of the current host buffer,
+        // the send buffer one host buffer, the samples of an unfinished window and the history of a model input
+        size_t ring_buffer_size = std::max(maxLatency + 2 * (newConfig.hostBufferSize + numNewSamples),
+                                           newConfig.hostBufferSize + 2 * (size_t) (inferenceConfig.m_new_model_input_size + inferenceConfig.m_new_model_output_size));
+
+        // The buffers of the previous prepare call must be released before the arena gets resized
+        sendBuffer.initialize(0, 0);
+        receiveBuffer.initialize(0, 0);
+        size_t arena_size = 2 * RingBuffer::getRequiredMemory(numChannels, ring_buffer_size);
+        arena_size += (size_t) n_structs * (AudioBufferF::getRequiredMemory(1, inferenceConfig.m_new_model_input_size) + AudioBufferF::getRequiredMemory(1, inferenceConfig.m_new_model_output_size));
+        memoryArena.reserve(arena_size);
+
+        sendBuffer.setAllocator(memoryArena);
+        receiveBuffer.setAllocator(memoryArena);
+        // Planar, so every channel is pushed from and popped to the host buffers with block copies
+        sendBuffer.initializeWithPositions(numChannels, ring_buffer_size);
+        receiveBuffer.initializeWithPositions(numChannels, ring_buffer_size);
 
         for (int i = 0; i < n_structs; ++i) {
-            inferenceQueue.emplace_back(std::make_unique<ThreadSafeStruct>(inferenceConfig.m_new_model_input_size, inferenceConfig.m_new_model_output_size));
+            inferenceQueue.emplace_back(std::make_unique<ThreadSafeStruct>(inferenceConfig.m_new_model_input_size, inferenceConfig.m_new_model_output_size, memoryArena));
+        }
+        // Only the ring buffers and slots of this configuration are locked
+        if (inferenceConfig.m_memory_lock != InferenceConfig::MemoryLockNone && !memoryArena.lock()) {
+            reportMemoryLockFailure("the session buffers", memoryArena.getUsedBytes());
         }
 
         timeStamps.reserve(n_structs);
+
+        silenceInputSamples = (size_t) inferenceConfig.m_new_model_input_size;
+        if (numChannels > 1 && inferenceConfig.m_channel_mode == InferenceConfig::ChannelBatched) {
+            silenceInputSamples /= numChannels;
+        }
+        // One more round, so that an inference on silent input is submitted before the gate closes and its output can be repeated
+        silenceGateSamples = silenceInputSamples + numNewSamples + (size_t) std::ceil(inferenceConfig.m_silence_hold * newConfig.hostSampleRate / 1000.f);
+        silenceResponses.clear();
+        if (inferenceConfig.m_silence_gate) {
+            for (size_t i = 0; i < getNumSlotsPerRound(); ++i) {
+                silenceResponses.emplace_back(1, inferenceConfig.m_new_model_output_size);
+            }
+        }
+        hasSilenceResponse.assign(silenceResponses.size(), false);
+        statistics.reset(numThreadSlots);
+
+        prePostProcessor.prepare(newConfig);
     }
 
 } // namespace anira
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <anira/scheduler/SessionStatistics.h>
+
+namespace anira {
+
+void SessionStatistics::reset(size_t numSlots) {
+    m_inference_time.reset();
+    m_queue_wait_time.reset();
+    m_missed_blocks.store(0, std::memory_order_relaxed);
+    m_caught_up_blocks.store(0, std::memory_order_relaxed);
+    m_queue_full_events.store(0, std::memory_order_relaxed);
+    m_reserve_slots_used.store(0, std::memory_order_relaxed);
+    m_dropped_inferences.store(0, std::memory_order_relaxed);
+    m_inline_fallbacks.store(0, std::memory_order_relaxed);
+    m_silent_inferences.store(0, std::memory_order_relaxed);
+    m_assisted_inferences.store(0, std::memory_order_relaxed);
+    m_occupied_slots.store(0, std::memory_order_relaxed);
+    m_max_occupied_slots.store(0, std::memory_order_relaxed);
+    m_num_slots.store(numSlots, std::memory_order_relaxed);
+    m_degraded.store(false, std::memory_order_relaxed);
+    m_num_fallbacks.store(0, std::memory_order_relaxed);
+}
+
+void SessionStatistics::setLatency(const LatencyBreakdown& latency) {
+    m_buffer_adaptation.store(latency.bufferAdaptation, std::memory_order_relaxed);
+    m_inference_caused_latency.store(latency.inferenceCausedLatency, std::memory_order_relaxed);
+    m_model_latency.store(latency.modelLatency, std::memory_order_relaxed);
+    m_total_latency.store(latency.totalLatency, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordInference(uint64_t inferenceTime, uint64_t queueWaitTime) {
+    m_inference_time.record(inferenceTime);
+    m_queue_wait_time.record(queueWaitTime);
+}
+
+void SessionStatistics::recordMissedBlock() {
+    m_missed_blocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordCaughtUpBlock() {
+    m_caught_up_blocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordQueueFull() {
+    m_queue_full_events.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordReserveSlotUsed() {
+    m_reserve_slots_used.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordDroppedInference() {
+    m_dropped_inferences.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordInlineFallback() {
+    m_inline_fallbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordSilentInferences(uint64_t numInferences) {
+    m_silent_inferences.fetch_add(numInferences, std::memory_order_relaxed);
+}
+
+void SessionStatistics::recordAssistedInference() {
+    m_assisted_inferences.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::slotSubmitted() {
+    size_t occupied = m_occupied_slots.fetch_add(1, std::memory_order_relaxed) + 1;
+    // Only the audio thread submits slots, so there is no concurrent writer of the maximum
+    if (occupied > m_max_occupied_slots.load(std::memory_order_relaxed)) {
+        m_max_occupied_slots.store(occupied, std::memory_order_relaxed);
+    }
+}
+
+void SessionStatistics::slotCollected() {
+    m_occupied_slots.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void SessionStatistics::setDegraded(bool degraded) {
+    m_degraded.store(degraded, std::memory_order_relaxed);
+    if (degraded) {
+        m_num_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SessionStatisticsSnapshot SessionStatistics::getSnapshot(InferenceBackend backend) const {
+    SessionStatisticsSnapshot snapshot;
+    snapshot.inferenceTime = m_inference_time.getSnapshot();
+    snapshot.queueWaitTime = m_queue_wait_time.getSnapshot();
+    snapshot.numInferences = snapshot.inferenceTime.count;
+    snapshot.missedBlocks = m_missed_blocks.load(std::memory_order_relaxed);
+    snapshot.caughtUpBlocks = m_caught_up_blocks.load(std::memory_order_relaxed);
+    snapshot.queueFullEvents = m_queue_full_events.load(std::memory_order_relaxed);
+    snapshot.reserveSlotsUsed = m_reserve_slots_used.load(std::memory_order_relaxed);
+    snapshot.droppedInferences = m_dropped_inferences.load(std::memory_order_relaxed);
+    snapshot.inlineFallbacks = m_inline_fallbacks.load(std::memory_order_relaxed);
+    snapshot.silentInferences = m_silent_inferences.load(std::memory_order_relaxed);
+    snapshot.assistedInferences = m_assisted_inferences.load(std::memory_order_relaxed);
+    snapshot.occupiedSlots = m_occupied_slots.load(std::memory_order_relaxed);
+    snapshot.maxOccupiedSlots = m_max_occupied_slots.load(std::memory_order_relaxed);
+    snapshot.numSlots = m_num_slots.load(std::memory_order_relaxed);
+    snapshot.backend = backend;
+    snapshot.latency.bufferAdaptation = m_buffer_adaptation.load(std::memory_order_relaxed);
+    snapshot.latency.inferenceCausedLatency = m_inference_caused_latency.load(std::memory_order_relaxed);
+    snapshot.latency.modelLatency = m_model_latency.load(std::memory_order_relaxed);
+    snapshot.latency.totalLatency = m_total_latency.load(std::memory_order_relaxed);
+    snapshot.degraded = m_degraded.load(std::memory_order_relaxed);
+    snapshot.numFallbacks = m_num_fallbacks.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace anira
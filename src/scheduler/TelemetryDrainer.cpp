@@ -0,0 +1,77 @@
+#include <anira/scheduler/TelemetryDrainer.h>
+#include <iostream>
+#include <cstdio>
+
+namespace anira {
+
+TelemetryDrainer::TelemetryDrainer(TelemetryRing& ring) : m_ring(ring) {
+}
+
+TelemetryDrainer::~TelemetryDrainer() {
+    stop();
+}
+
+void TelemetryDrainer::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running) return;
+    m_running = true;
+    m_thread = std::thread(&TelemetryDrainer::run, this);
+}
+
+void TelemetryDrainer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) return;
+        m_running = false;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    drain();
+}
+
+bool TelemetryDrainer::isRunning() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_running;
+}
+
+void TelemetryDrainer::setListener(Listener listener) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_listener = std::move(listener);
+}
+
+void TelemetryDrainer::drain() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TelemetryEvent event;
+    while (m_ring.pop(event)) {
+        if (m_listener) {
+            m_listener(event);
+        } else {
+            print(event);
+        }
+    }
+}
+
+void TelemetryDrainer::print(const TelemetryEvent& event) {
+    const char* prefix = getTelemetryLevel(event.type) == TELEMETRY_WARNING ? "[WARNING]" : "[INFO]";
+#ifndef BELA
+    std::cout << prefix << " " << getTelemetryEventName(event.type) << "! Session: " << event.sessionID << ", value: " << event.value << std::endl;
+#else
+    printf("%s %s! Session: %d, value: %lld\n", prefix, getTelemetryEventName(event.type), event.sessionID, (long long) event.value);
+#endif
+}
+
+void TelemetryDrainer::run() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_condition.wait_for(lock, DRAIN_INTERVAL, [this] { return !m_running; })) {
+                return;
+            }
+        }
+        drain();
+    }
+}
+
+} // namespace anira
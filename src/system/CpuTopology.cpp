@@ -0,0 +1,201 @@
+#include <anira/system/CpuTopology.h>
+#include <anira/InferenceConfig.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if WIN32
+    #include <windows.h>
+#elif __linux__
+    #include <sched.h>
+#endif
+
+namespace anira {
+
+namespace {
+
+#if __linux__
+std::string readFirstLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+#endif
+
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+#if WIN32
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &length);
+    std::vector<char> buffer(length);
+    if (length > 0 && GetLogicalProcessorInformationEx(RelationProcessorCore, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length)) {
+        for (DWORD offset = 0; offset < length;) {
+            auto* info = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data() + offset);
+            // Only the first processor group, the affinity masks of the other groups need the group apis
+            if (info->Processor.GroupMask[0].Group == 0) {
+                KAFFINITY mask = info->Processor.GroupMask[0].Mask;
+                int core = -1;
+                for (int cpu = 0; cpu < (int) sizeof(KAFFINITY) * 8; ++cpu) {
+                    if (mask & ((KAFFINITY) 1 << cpu)) {
+                        core = core < 0 ? cpu : core;
+                        topology.m_cpus.push_back({cpu, core, (int) info->Processor.EfficiencyClass + 1});
+                    }
+                }
+            }
+            offset += info->Size;
+        }
+    }
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask);
+    for (const auto& cpu : topology.m_cpus) {
+        if (process_mask & ((DWORD_PTR) 1 << cpu.id)) {
+            topology.m_allowed.push_back(cpu.id);
+        }
+    }
+#elif __linux__
+    std::vector<int> online = parseCpuList(readFirstLine("/sys/devices/system/cpu/online"));
+    // Intel hybrid cpus list their P-cores and E-cores as separate pmu devices
+    std::vector<int> performance_cores = parseCpuList(readFirstLine("/sys/devices/cpu_core/cpus"));
+    std::vector<int> efficiency_cores = parseCpuList(readFirstLine("/sys/devices/cpu_atom/cpus"));
+    for (int id : online) {
+        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(id);
+        CpuInfo cpu;
+        cpu.id = id;
+        std::vector<int> siblings = parseCpuList(readFirstLine(path + "/topology/thread_siblings_list"));
+        cpu.core = siblings.empty() ? id : *std::min_element(siblings.begin(), siblings.end());
+        std::string capacity = readFirstLine(path + "/cpu_capacity");
+        if (!capacity.empty()) {
+            cpu.capacity = std::stoi(capacity);
+        } else if (std::find(efficiency_cores.begin(), efficiency_cores.end(), id) != efficiency_cores.end()) {
+            cpu.capacity = 512;
+        } else if (!performance_cores.empty() && std::find(performance_cores.begin(), performance_cores.end(), id) == performance_cores.end()) {
+            cpu.capacity = 512;
+        }
+        topology.m_cpus.push_back(cpu);
+    }
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (const auto& cpu : topology.m_cpus) {
+        if (!has_mask || CPU_ISSET(cpu.id, &allowed)) {
+            topology.m_allowed.push_back(cpu.id);
+        }
+    }
+    topology.m_isolated = parseCpuList(readFirstLine("/sys/devices/system/cpu/isolated"));
+#endif
+    if (topology.m_cpus.empty()) {
+        for (int id = 0; id < (int) std::max(std::thread::hardware_concurrency(), 1u); ++id) {
+            topology.m_cpus.push_back({id, id, 1024});
+            topology.m_allowed.push_back(id);
+        }
+    }
+    return topology;
+}
+
+const CpuInfo* CpuTopology::getCpu(int id) const {
+    for (const auto& cpu : m_cpus) {
+        if (cpu.id == id) {
+            return &cpu;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::vector<int>> CpuTopology::selectCpus(int affinityFlags, const std::vector<int>& explicitCpus, int callerCpu, size_t numThreads) const {
+    std::vector<std::vector<int>> result(numThreads);
+    if (affinityFlags == InferenceConfig::AffinityNone && explicitCpus.empty()) {
+        return result;
+    }
+
+    // Isolated cpus are not used by the scheduler on its own, so they are the first choice if there are any
+    std::vector<int> candidates;
+    const std::vector<int>& base = !explicitCpus.empty() ? explicitCpus : (!m_isolated.empty() ? m_isolated : m_allowed);
+    for (int id : base) {
+        if (getCpu(id) != nullptr && std::find(candidates.begin(), candidates.end(), id) == candidates.end()) {
+            candidates.push_back(id);
+        }
+    }
+
+    if (affinityFlags & InferenceConfig::AffinityHighCapacity) {
+        int max_capacity = 0;
+        for (int id : candidates) {
+            max_capacity = std::max(max_capacity, getCpu(id)->capacity);
+        }
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&] (int id) { return getCpu(id)->capacity < max_capacity; }), candidates.end());
+    }
+
+    const CpuInfo* caller = getCpu(callerCpu);
+    if ((affinityFlags & InferenceConfig::AffinityAvoidCaller) && caller != nullptr) {
+        std::vector<int> remaining = candidates;
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&] (int id) { return getCpu(id)->core == caller->core; }), remaining.end());
+        // With nothing left the threads rather share the core than not run
+        if (!remaining.empty()) {
+            candidates = remaining;
+        }
+    }
+
+    if (candidates.empty()) {
+        return result;
+    }
+
+    if (affinityFlags & InferenceConfig::AffinityPhysicalCores) {
+        // First logical cpu of every core, the threads are pinned to them round robin
+        std::vector<int> cores;
+        std::vector<int> core_ids;
+        for (int id : candidates) {
+            int core = getCpu(id)->core;
+            if (std::find(core_ids.begin(), core_ids.end(), core) == core_ids.end()) {
+                core_ids.push_back(core);
+                cores.push_back(id);
+            }
+        }
+        for (size_t i = 0; i < numThreads; ++i) {
+            result[i] = {cores[i % cores.size()]};
+        }
+    } else {
+        for (auto& cpus : result) {
+            cpus = candidates;
+        }
+    }
+    return result;
+}
+
+int CpuTopology::getCurrentCpu() {
+#if WIN32
+    return (int) GetCurrentProcessorNumber();
+#elif __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+std::vector<int> CpuTopology::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range.find_first_not_of(" \t\n") == std::string::npos) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Not a cpu list, e.g. an empty sysfs file
+        }
+    }
+    return cpus;
+}
+
+} // namespace anira
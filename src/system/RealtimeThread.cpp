@@ -1,7 +1,45 @@
 #include <anira/system/RealtimeThread.h>
+#if __linux__ || __APPLE__
+    #include <time.h>
+    #include <alloca.h>
+#elif WIN32
+    #include <malloc.h>
+#endif
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+#endif
+#if __linux__
+    #include <sched.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+
+    #ifndef SCHED_DEADLINE
+        #define SCHED_DEADLINE 6
+    #endif
+#endif
 
 namespace anira {
 
+#if __linux__
+namespace {
+
+// Layout of struct sched_attr of the kernel, older glibc versions do not declare it
+struct DeadlineAttributes {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+
+}
+#endif
+
 RealtimeThread::RealtimeThread() : m_should_exit(false){
 }
 
@@ -11,22 +49,51 @@ RealtimeThread::~RealtimeThread() {
 
 void RealtimeThread::start() {
     m_should_exit = false;
-    #if __linux__
-        pthread_attr_t thread_attr;
-        pthread_attr_init(&thread_attr);
-        pthread_attr_setinheritsched(&thread_attr, PTHREAD_EXPLICIT_SCHED);
-        pthread_setattr_default_np(&thread_attr);
-    #endif
+    m_tid = 0;
+    m_deadline_active = false;
+    m_initialized = false;
+    thread = std::thread([this] {
+        initialize();
+        run();
+    });
 
-    thread = std::thread(&RealtimeThread::run, this);
+    // Waiting keeps the scheduling changes of the new thread and later calls like setDeadlineScheduling in order
+    while (!m_initialized) {
+        std::this_thread::yield();
+    }
+}
 
-    #if __linux__
-        pthread_attr_destroy(&thread_attr);
-    #endif
+void RealtimeThread::initialize() {
+#if __linux__
+    m_tid = (int) syscall(SYS_gettid);
+#endif
+    if (!m_init_policy.name.empty()) {
+        setCurrentThreadName(m_init_policy.name);
+    }
+    if (m_init_policy.flushDenormals) {
+        flushDenormalsToZero();
+    }
+    if (m_init_policy.stackPrefaultSize > 0) {
+        prefaultStack(m_init_policy.stackPrefaultSize);
+    }
 
-    elevateToRealTimePriority(thread.native_handle());
+#if WIN32
+    elevateToRealTimePriority(GetCurrentThread());
+#else
+    elevateToRealTimePriority(pthread_self());
+#endif
+    applyAffinity();
+    // Applied after SCHED_FIFO, which stays as the fallback if the kernel refuses the reservation
+    if (m_deadline_period > 0) {
+        applyDeadlineScheduling();
     }
 
+    if (m_init_policy.hook) {
+        m_init_policy.hook();
+    }
+    m_initialized = true;
+}
+
 void RealtimeThread::stop() {
     m_should_exit = true;
     if (thread.joinable()) thread.join();
@@ -49,46 +116,36 @@ void RealtimeThread::elevateToRealTimePriority(std::thread::native_handle_type t
         }
     }
 #elif __linux__
-    int ret;
-
-    if (!is_main_process) {
-        int attr_inheritsched;
-        pthread_attr_t thread_attr;
-        ret = pthread_getattr_np(thread_native_handle, &thread_attr);
-        ret = pthread_attr_getinheritsched(&thread_attr, &attr_inheritsched);
-        if(ret != 0) {
-            std::cerr << "[ERROR] Failed to get Thread scheduling policy and params : " << errno << std::endl;\
-        }
-        if (attr_inheritsched != PTHREAD_EXPLICIT_SCHED) {
-            std::cerr << "[ERROR] Thread scheduling policy is not PTHREAD_EXPLICIT_SCHED. Possibly thread attributes get inherited from the main process." << std::endl;
-        }
-        pthread_attr_destroy(&thread_attr);
-    }
-
+    (void) is_main_process;
     int sch_policy;
     struct sched_param sch_params;
 
-    ret = pthread_getschedparam(thread_native_handle, &sch_policy, &sch_params);
+    int ret = pthread_getschedparam(thread_native_handle, &sch_policy, &sch_params);
     if(ret != 0) {
-        std::cerr << "[ERROR] Failed to get Thread scheduling policy and params : " << errno << std::endl;
+        std::cerr << "[ERROR] Failed to get Thread scheduling policy and params : " << ret << std::endl;
     }
 
     // Pipewire uses SCHED_FIFO 60 and juce plugin host uses SCHED_FIFO 55 better stay below
     sch_params.sched_priority = 50;
 
     ret = pthread_setschedparam(thread_native_handle, SCHED_FIFO, &sch_params); 
-    if(ret != 0) {
-        std::cerr << "[ERROR] Failed to set Thread scheduling policy to SCHED_FIFO and increase the sched_priority to " << sch_params.sched_priority << ". Error : " << errno << std::endl;
-        std::cout << "[WARNING] Give rtprio privileges to the user by adding the user to the realtime/audio group. Or run the application as root." << std::endl;
-        std::cout << "[WARNING] Instead, trying to set increased nice value for SCHED_OTHER..." << std::endl;
+    if(ret == 0) {
+        return;
     }
+    std::cerr << "[ERROR] Failed to set Thread scheduling policy to SCHED_FIFO and increase the sched_priority to " << sch_params.sched_priority << ". Error : " << ret << std::endl;
+    std::cout << "[WARNING] Give rtprio privileges to the user by adding the user to the realtime/audio group. Or run the application as root." << std::endl;
 
-    // TODO Check if PRIO_PROCESS is the right who to set the nice value, since it should only affect the current process id, still it works
-    ret = setpriority(PRIO_PROCESS, 0, -10);
+    // The nice value belongs to a single thread on Linux, setpriority with the thread id leaves the rest of the process alone
+    if (!pthread_equal(thread_native_handle, pthread_self())) {
+        return;
+    }
+    std::cout << "[WARNING] Instead, trying to set increased nice value for SCHED_OTHER..." << std::endl;
+    pid_t tid = (pid_t) syscall(SYS_gettid);
+    ret = setpriority(PRIO_PROCESS, (id_t) tid, -10);
 
     if(ret != 0) {
         std::cerr << "[ERROR] Failed to set increased nice value. Error : " << errno << std::endl;
-        std::cout << "[WARNING] Using default nice value: " << getpriority(PRIO_PROCESS, 0) << std::endl;
+        std::cout << "[WARNING] Using default nice value: " << getpriority(PRIO_PROCESS, (id_t) tid) << std::endl;
     }
     return;
 #elif __APPLE__
@@ -116,4 +173,175 @@ bool RealtimeThread::shouldExit() {
     return m_should_exit;
 }
 
-} // namespace anira
\ No newline at end of file
+bool RealtimeThread::setDeadlineScheduling(uint64_t runtime, uint64_t deadline, uint64_t period) {
+    m_deadline_runtime = runtime;
+    m_deadline_deadline = deadline;
+    m_deadline_period = period;
+    if (!thread.joinable()) {
+        return true;
+    }
+    if (period == 0) {
+        if (m_deadline_active) {
+            elevateToRealTimePriority(thread.native_handle());
+            m_deadline_active = false;
+        }
+        return true;
+    }
+    return applyDeadlineScheduling();
+}
+
+bool RealtimeThread::isDeadlineScheduled() const {
+    return m_deadline_active;
+}
+
+bool RealtimeThread::applyDeadlineScheduling() {
+#if __linux__
+    // The thread id is written first thing on the new thread
+    while (m_tid == 0) {
+        std::this_thread::yield();
+    }
+    DeadlineAttributes attributes {};
+    attributes.size = sizeof(DeadlineAttributes);
+    attributes.sched_policy = SCHED_DEADLINE;
+    attributes.sched_runtime = m_deadline_runtime;
+    attributes.sched_deadline = m_deadline_deadline;
+    attributes.sched_period = m_deadline_period;
+    if (syscall(SYS_sched_setattr, m_tid.load(), &attributes, 0) != 0) {
+        // A refused change leaves the previous policy in place
+        std::cerr << "[ERROR] Failed to set Thread scheduling policy to SCHED_DEADLINE with runtime " << m_deadline_runtime << " ns, deadline " << m_deadline_deadline << " ns and period " << m_deadline_period << " ns. Error : " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    m_deadline_active = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RealtimeThread::flushDenormalsToZero() {
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    // FTZ is bit 15 and DAZ bit 6 of the MXCSR
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#elif defined(__aarch64__)
+    // FZ is bit 24 of the FPCR and covers inputs and outputs
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    asm volatile("msr fpcr, %0" : : "r"(fpcr | (1ull << 24)));
+#elif defined(__arm__) && defined(__ARM_FP)
+    uint32_t fpscr;
+    asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    asm volatile("vmsr fpscr, %0" : : "r"(fpscr | (1u << 24)));
+#endif
+}
+
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+void RealtimeThread::prefaultStack(size_t size) {
+    // One write per page is enough, volatile keeps the compiler from dropping them
+#if WIN32
+    volatile char* stack = static_cast<volatile char*>(_alloca(size));
+#else
+    volatile char* stack = static_cast<volatile char*>(alloca(size));
+#endif
+    for (size_t i = 0; i < size; i += 4096) {
+        stack[i] = 0;
+    }
+    stack[size - 1] = 0;
+}
+
+void RealtimeThread::setCurrentThreadName(const std::string& name) {
+#if WIN32
+    std::wstring wide_name(name.begin(), name.end());
+    SetThreadDescription(GetCurrentThread(), wide_name.c_str());
+#elif __linux__
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif __APPLE__
+    pthread_setname_np(name.c_str());
+#endif
+}
+
+void RealtimeThread::setInitPolicy(const ThreadInitPolicy& policy) {
+    m_init_policy = policy;
+}
+
+void RealtimeThread::setAffinity(const std::vector<int>& cpus) {
+    m_affinity = cpus;
+}
+
+std::vector<int> RealtimeThread::getAffinity() const {
+    std::vector<int> cpus;
+#if __linux__
+    if (m_tid == 0) {
+        return m_affinity;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(m_tid.load(), sizeof(set), &set) != 0) {
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push_back(cpu);
+        }
+    }
+#else
+    // There is no getter for the thread affinity, so report what was applied
+    cpus = m_affinity;
+#endif
+    return cpus;
+}
+
+void RealtimeThread::applyAffinity() {
+    if (m_affinity.empty()) {
+        return;
+    }
+#if WIN32
+    DWORD_PTR mask = 0;
+    for (int cpu : m_affinity) {
+        if (cpu >= 0 && cpu < (int) sizeof(DWORD_PTR) * 8) {
+            mask |= (DWORD_PTR) 1 << cpu;
+        }
+    }
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        std::cerr << "[ERROR] Failed to set Thread affinity. Error: " << GetLastError() << std::endl;
+    }
+#elif __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : m_affinity) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (ret != 0) {
+        std::cerr << "[ERROR] Failed to set Thread affinity. Error : " << std::strerror(ret) << std::endl;
+    }
+#endif
+}
+
+uint64_t RealtimeThread::getCurrentThreadCpuTime() {
+#if WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return 0;
+    }
+    // FILETIME counts in 100 ns steps
+    uint64_t kernel = ((uint64_t) kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime;
+    uint64_t user = ((uint64_t) user_time.dwHighDateTime << 32) | user_time.dwLowDateTime;
+    return (kernel + user) * 100;
+#elif __linux__ || __APPLE__
+    struct timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return 0;
+    }
+    return (uint64_t) time.tv_sec * 1000000000ull + (uint64_t) time.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+} // namespace anira
@@ -0,0 +1,110 @@
+#include <anira/utils/AtomicHistogram.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace anira {
+
+namespace {
+constexpr uint64_t FIRST_BUCKET_BOUND = 1000;
+constexpr double BUCKETS_PER_OCTAVE = 4.;
+}
+
+double HistogramSnapshot::getMean() const {
+    return count == 0 ? 0. : (double) sum / (double) count;
+}
+
+double HistogramSnapshot::getPercentile(double percentile) const {
+    if (count == 0) return 0.;
+    uint64_t rank = (uint64_t) std::ceil(std::clamp(percentile, 0., 100.) / 100. * (double) count);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        cumulative += buckets[i];
+        if (cumulative >= rank) {
+            return (double) std::min(getBucketUpperBound(i), max);
+        }
+    }
+    return (double) max;
+}
+
+HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot& older) const {
+    HistogramSnapshot difference;
+    difference.count = count - older.count;
+    difference.sum = sum - older.sum;
+    size_t first = NUM_BUCKETS;
+    size_t last = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        difference.buckets[i] = buckets[i] - older.buckets[i];
+        if (difference.buckets[i] > 0) {
+            first = std::min(first, i);
+            last = i;
+        }
+    }
+    if (first < NUM_BUCKETS) {
+        difference.min = std::max(getBucketLowerBound(first), min);
+        difference.max = std::min(getBucketUpperBound(last), max);
+    }
+    return difference;
+}
+
+size_t HistogramSnapshot::getBucketIndex(uint64_t value) {
+    if (value < FIRST_BUCKET_BOUND) return 0;
+    double index = 1. + std::floor(BUCKETS_PER_OCTAVE * std::log2((double) value / (double) FIRST_BUCKET_BOUND));
+    return std::min((size_t) index, NUM_BUCKETS - 1);
+}
+
+uint64_t HistogramSnapshot::getBucketLowerBound(size_t index) {
+    if (index == 0) return 0;
+    return (uint64_t) ((double) FIRST_BUCKET_BOUND * std::exp2((double) (index - 1) / BUCKETS_PER_OCTAVE));
+}
+
+uint64_t HistogramSnapshot::getBucketUpperBound(size_t index) {
+    if (index == NUM_BUCKETS - 1) return std::numeric_limits<uint64_t>::max();
+    return getBucketLowerBound(index + 1);
+}
+
+AtomicHistogram::AtomicHistogram() {
+    reset();
+}
+
+void AtomicHistogram::record(uint64_t value) {
+    m_buckets[HistogramSnapshot::getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current_min = m_min.load(std::memory_order_relaxed);
+    while (value < current_min && !m_min.compare_exchange_weak(current_min, value, std::memory_order_relaxed)) {}
+    uint64_t current_max = m_max.load(std::memory_order_relaxed);
+    while (value > current_max && !m_max.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {}
+
+    // The count is written last, so a snapshot never sees more values than the buckets hold
+    m_count.fetch_add(1, std::memory_order_release);
+}
+
+HistogramSnapshot AtomicHistogram::getSnapshot() const {
+    HistogramSnapshot snapshot;
+    snapshot.count = m_count.load(std::memory_order_acquire);
+    uint64_t bucket_count = 0;
+    for (size_t i = 0; i < HistogramSnapshot::NUM_BUCKETS; ++i) {
+        snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        bucket_count += snapshot.buckets[i];
+    }
+    // Values recorded while copying only show up in the buckets, count them as well so percentiles stay consistent
+    snapshot.count = std::max(snapshot.count, bucket_count);
+    snapshot.sum = m_sum.load(std::memory_order_relaxed);
+    snapshot.min = snapshot.count == 0 ? 0 : m_min.load(std::memory_order_relaxed);
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void AtomicHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+} // namespace anira
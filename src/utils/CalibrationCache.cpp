@@ -0,0 +1,109 @@
+#include <anira/utils/CalibrationCache.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+namespace anira {
+
+CalibrationCache::CalibrationCache(const std::string& path) : m_path(path) {
+    std::ifstream file(m_path);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t separator = line.rfind('\t');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        try {
+            m_entries[line.substr(0, separator)] = std::stof(line.substr(separator + 1));
+        } catch (const std::exception&) {
+            // Skip malformed lines
+        }
+    }
+}
+
+bool CalibrationCache::get(const std::string& key, float& maxInferenceTime) const {
+    auto entry = m_entries.find(key);
+    if (entry == m_entries.end()) {
+        return false;
+    }
+    maxInferenceTime = entry->second;
+    return true;
+}
+
+bool CalibrationCache::set(const std::string& key, float maxInferenceTime) {
+    m_entries[key] = maxInferenceTime;
+    std::ofstream file(m_path, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    for (const auto& entry : m_entries) {
+        file << entry.first << '\t' << entry.second << '\n';
+    }
+    return file.good();
+}
+
+std::string CalibrationCache::getKey(const InferenceConfig& config, InferenceBackend backend) {
+    std::stringstream key;
+    std::string model_path = config.getModelPath(backend);
+    std::error_code error;
+    if (!model_path.empty() && std::filesystem::exists(model_path, error)) {
+        auto path = std::filesystem::absolute(model_path, error);
+        key << path.string() << '|' << std::filesystem::file_size(path, error) << '|' << std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    } else {
+        key << (model_path.empty() ? "no_model" : model_path);
+    }
+    key << '|' << getInferenceBackendName(backend);
+    key << '|' << config.m_new_model_input_size << 'x' << config.m_new_model_output_size;
+    key << "|p" << config.m_calibration_percentile;
+    key << '|' << getCpuName();
+    // Tabs and line breaks would break the file format
+    std::string result = key.str();
+    for (char& c : result) {
+        if (c == '\t' || c == '\n' || c == '\r') {
+            c = ' ';
+        }
+    }
+    return result;
+}
+
+std::string CalibrationCache::getCpuName() {
+    std::string name;
+#if defined(__APPLE__)
+    char buffer[256];
+    size_t size = sizeof(buffer);
+    if (sysctlbyname("machdep.cpu.brand_string", buffer, &size, nullptr, 0) == 0) {
+        name = std::string(buffer);
+    }
+#elif defined(__linux__)
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        // x86 reports "model name", most arm kernels only report "Model" or "Hardware"
+        if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0 || line.rfind("Hardware", 0) == 0) {
+            size_t start = line.find_first_not_of(" \t", line.find(':') + 1);
+            if (line.find(':') != std::string::npos && start != std::string::npos) {
+                name = line.substr(start);
+                break;
+            }
+        }
+    }
+#elif defined(_WIN32)
+    const char* identifier = std::getenv("PROCESSOR_IDENTIFIER");
+    if (identifier != nullptr) {
+        name = identifier;
+    }
+#endif
+    if (name.empty()) {
+        name = "unknown cpu";
+    }
+    return name + " (" + std::to_string(std::thread::hardware_concurrency()) + " threads)";
+}
+
+} // namespace anira
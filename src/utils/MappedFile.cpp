@@ -0,0 +1,118 @@
+#include <anira/utils/MappedFile.h>
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#if WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace anira {
+
+namespace {
+
+std::mutex& getRegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Weak, so a file is unmapped as soon as the last backend that uses it is gone
+std::map<std::string, std::weak_ptr<const MappedFile>>& getRegistry() {
+    static std::map<std::string, std::weak_ptr<const MappedFile>> registry;
+    return registry;
+}
+
+}
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path, bool hugePages) {
+    std::error_code error;
+    std::string key = std::filesystem::weakly_canonical(path, error).string();
+    if (error) {
+        key = path;
+    }
+
+    std::lock_guard<std::mutex> lock(getRegistryMutex());
+    auto& registry = getRegistry();
+    auto entry = registry.find(key);
+    if (entry != registry.end()) {
+        if (auto file = entry->second.lock()) {
+            return file;
+        }
+    }
+    std::shared_ptr<const MappedFile> file(new MappedFile(path, hugePages));
+    registry[key] = file;
+    return file;
+}
+
+MappedFile::MappedFile(const std::string& path, bool hugePages) {
+#if WIN32
+    (void) hugePages;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open the model file " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error("Could not read the size of the model file " + path);
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr) {
+        if (mapping != nullptr) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Could not map the model file " + path);
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = data;
+    m_size = (size_t) size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open the model file " + path);
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not read the size of the model file " + path);
+    }
+    void* data = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Could not map the model file " + path);
+    }
+    m_data = data;
+    m_size = (size_t) status.st_size;
+
+    // The runtimes read the whole file while loading, so start reading it in right away
+    madvise(data, m_size, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+    if (hugePages) {
+        madvise(data, m_size, MADV_HUGEPAGE);
+    }
+#else
+    (void) hugePages;
+#endif
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+#else
+    munmap(const_cast<void*>(m_data), m_size);
+#endif
+}
+
+} // namespace anira
@@ -0,0 +1,19 @@
+#include <anira/utils/MemoryAllocator.h>
+#include <new>
+
+namespace anira {
+
+MemoryAllocator& MemoryAllocator::getDefault() {
+    static DefaultAllocator defaultAllocator;
+    return defaultAllocator;
+}
+
+void* DefaultAllocator::allocate(size_t size, size_t alignment) {
+    return ::operator new(size, std::align_val_t(alignment));
+}
+
+void DefaultAllocator::deallocate(void* ptr, [[maybe_unused]] size_t size, size_t alignment) {
+    ::operator delete(ptr, std::align_val_t(alignment));
+}
+
+} // namespace anira
@@ -0,0 +1,93 @@
+#include <anira/utils/MemoryArena.h>
+#include <anira/utils/MemoryLock.h>
+#include <cstring>
+
+namespace anira {
+
+// The region itself is page aligned, so that locking and prefaulting operate on whole pages
+constexpr size_t PAGE_ALIGNMENT = 4096;
+
+MemoryArena::MemoryArena() = default;
+
+MemoryArena::~MemoryArena() {
+    release();
+}
+
+void MemoryArena::reserve(size_t capacity) {
+    capacity = alignUp(capacity, PAGE_ALIGNMENT);
+    unlock();
+    if (capacity > m_capacity) {
+        release();
+        m_p_region = static_cast<std::byte*>(MemoryAllocator::getDefault().allocate(capacity, PAGE_ALIGNMENT));
+        m_capacity = capacity;
+        // Touch every page now, so that the first access from the real-time thread does not cause a page fault
+        std::memset(m_p_region, 0, m_capacity);
+    }
+    reset();
+}
+
+void MemoryArena::reset() {
+    m_offset = 0;
+}
+
+void MemoryArena::release() {
+    if (m_p_region != nullptr) {
+        unlock();
+        MemoryAllocator::getDefault().deallocate(m_p_region, m_capacity, PAGE_ALIGNMENT);
+    }
+    m_p_region = nullptr;
+    m_capacity = 0;
+    m_offset = 0;
+}
+
+void* MemoryArena::allocate(size_t size, size_t alignment) {
+    size_t offset = alignUp(m_offset, alignment);
+    if (m_p_region == nullptr || offset + size > m_capacity) {
+        return MemoryAllocator::getDefault().allocate(size, alignment);
+    }
+    m_offset = offset + size;
+    return m_p_region + offset;
+}
+
+void MemoryArena::deallocate(void* ptr, size_t size, size_t alignment) {
+    // Memory inside the region is reclaimed as a whole with reset()
+    if (!owns(ptr)) {
+        MemoryAllocator::getDefault().deallocate(ptr, size, alignment);
+    }
+}
+
+bool MemoryArena::lock() {
+    if (m_p_region == nullptr || m_locked) return m_locked;
+    // Only the pages in use, a region that grew for an earlier, larger configuration keeps its unused tail unlocked
+    m_locked_size = alignUp(m_offset, PAGE_ALIGNMENT);
+    m_locked = m_locked_size == 0 || lockMemory(m_p_region, m_locked_size);
+    return m_locked;
+}
+
+void MemoryArena::unlock() {
+    if (!m_locked) return;
+    if (m_locked_size > 0) {
+        unlockMemory(m_p_region, m_locked_size);
+    }
+    m_locked = false;
+    m_locked_size = 0;
+}
+
+bool MemoryArena::isLocked() const {
+    return m_locked;
+}
+
+size_t MemoryArena::getCapacity() const {
+    return m_capacity;
+}
+
+size_t MemoryArena::getUsedBytes() const {
+    return m_offset;
+}
+
+bool MemoryArena::owns(const void* ptr) const {
+    const std::byte* p = static_cast<const std::byte*>(ptr);
+    return m_p_region != nullptr && p >= m_p_region && p < m_p_region + m_capacity;
+}
+
+} // namespace anira
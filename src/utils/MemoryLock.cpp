@@ -0,0 +1,76 @@
+#include <anira/utils/MemoryLock.h>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+#if WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/resource.h>
+#endif
+
+namespace anira {
+
+bool lockMemory(const void* ptr, size_t size) {
+    if (ptr == nullptr || size == 0) return true;
+#if WIN32
+    return VirtualLock(const_cast<void*>(ptr), size) != 0;
+#else
+    return mlock(ptr, size) == 0;
+#endif
+}
+
+void unlockMemory(const void* ptr, size_t size) {
+    if (ptr == nullptr || size == 0) return;
+#if WIN32
+    VirtualUnlock(const_cast<void*>(ptr), size);
+#else
+    munlock(ptr, size);
+#endif
+}
+
+bool lockAllMemory() {
+#if __linux__
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#else
+    return false;
+#endif
+}
+
+size_t getMemoryLockLimit() {
+#if WIN32
+    return SIZE_MAX;
+#else
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+        return SIZE_MAX;
+    }
+    return (size_t) limit.rlim_cur;
+#endif
+}
+
+void reportMemoryLockFailure(const char* what, size_t size) {
+    size_t limit = getMemoryLockLimit();
+#ifndef BELA
+    std::cout << "[WARNING] Could not lock " << what;
+    if (size > 0) {
+        std::cout << " (" << size << " bytes)";
+    }
+    std::cout << " in memory, page faults can cause dropouts." << std::endl;
+    if (limit != SIZE_MAX) {
+        std::cout << "[WARNING] RLIMIT_MEMLOCK is " << limit << " bytes. Raise it with ulimit -l or memlock in /etc/security/limits.conf, or give the process CAP_IPC_LOCK." << std::endl;
+    }
+#else
+    if (size > 0) {
+        printf("[WARNING] Could not lock %s (%zu bytes) in memory, page faults can cause dropouts.\n", what, size);
+    } else {
+        printf("[WARNING] Could not lock %s in memory, page faults can cause dropouts.\n", what);
+    }
+    if (limit != SIZE_MAX) {
+        printf("[WARNING] RLIMIT_MEMLOCK is %zu bytes. Raise it with ulimit -l or memlock in /etc/security/limits.conf, or give the process CAP_IPC_LOCK.\n", limit);
+    }
+#endif
+}
+
+} // namespace anira
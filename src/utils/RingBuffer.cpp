@@ -1,4 +1,7 @@
 #include <anira/utils/RingBuffer.h>
+#include <anira/utils/SimdKernels.h>
+#include <algorithm>
+#include <cmath>
 
 namespace anira {
 
@@ -6,6 +9,7 @@ RingBuffer::RingBuffer() = default;
 
 void RingBuffer::initializeWithPositions(size_t numChannels, size_t numSamples) {
     initialize(numChannels, numSamples);
+    clear();
     readPos.resize(getNumChannels());
     writePos.resize(getNumChannels());
 
@@ -65,4 +69,69 @@ size_t RingBuffer::getAvailableSamples(size_t channel) {
     return returnValue;
 }
 
+size_t RingBuffer::getMinAvailableSamples() {
+    size_t min_available = getNumChannels() > 0 ? getAvailableSamples(0) : 0;
+    for (size_t channel = 1; channel < getNumChannels(); ++channel) {
+        min_available = std::min(min_available, getAvailableSamples(channel));
+    }
+    return min_available;
+}
+
+void RingBuffer::pushSamples(size_t channel, const float* samples, size_t numSamples) {
+    size_t first = std::min(numSamples, getNumSamples() - writePos[channel]);
+    simd::copy(getWritePointer(channel, writePos[channel]), samples, first);
+    simd::copy(getWritePointer(channel), samples + first, numSamples - first);
+
+    writePos[channel] += numSamples;
+
+    if (writePos[channel] >= getNumSamples()) {
+        writePos[channel] -= getNumSamples();
+    }
+}
+
+void RingBuffer::popSamples(size_t channel, float* samples, size_t numSamples) {
+    size_t first = std::min(numSamples, getNumSamples() - readPos[channel]);
+    simd::copy(samples, getReadPointer(channel, readPos[channel]), first);
+    simd::copy(samples + first, getReadPointer(channel), numSamples - first);
+
+    readPos[channel] += numSamples;
+
+    if (readPos[channel] >= getNumSamples()) {
+        readPos[channel] -= getNumSamples();
+    }
+}
+
+void RingBuffer::getSamplesFromTail(size_t channel, size_t offset, float* samples, size_t numSamples) {
+    size_t start = readPos[channel] >= offset ? readPos[channel] - offset : getNumSamples() + readPos[channel] - offset;
+    size_t first = std::min(numSamples, getNumSamples() - start);
+    simd::copy(samples, getReadPointer(channel, start), first);
+    simd::copy(samples + first, getReadPointer(channel), numSamples - first);
+}
+
+const float* RingBuffer::getContiguousTail(size_t channel, size_t offset, size_t numSamples) const {
+    size_t start = readPos[channel] >= offset ? readPos[channel] - offset : getNumSamples() + readPos[channel] - offset;
+    if (start + numSamples > getNumSamples()) {
+        return nullptr;
+    }
+    return getReadPointer(channel, start);
+}
+
+void RingBuffer::discardSamples(size_t channel, size_t numSamples) {
+    readPos[channel] = (readPos[channel] + numSamples) % getNumSamples();
+}
+
+float RingBuffer::getPeak(size_t channel, size_t numSamples) const {
+    size_t first = std::min(numSamples, getNumSamples() - readPos[channel]);
+    const float* samples = getReadPointer(channel, readPos[channel]);
+    float peak = 0.f;
+    for (size_t i = 0; i < first; ++i) {
+        peak = std::max(peak, std::abs(samples[i]));
+    }
+    samples = getReadPointer(channel);
+    for (size_t i = 0; i < numSamples - first; ++i) {
+        peak = std::max(peak, std::abs(samples[i]));
+    }
+    return peak;
+}
+
 } // namespace anira
\ No newline at end of file
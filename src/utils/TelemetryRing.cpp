@@ -0,0 +1,70 @@
+#include <anira/utils/TelemetryRing.h>
+
+namespace anira {
+
+TelemetryRing::TelemetryRing(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    m_cells = std::make_unique<Cell[]>(size);
+    m_mask = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool TelemetryRing::push(const TelemetryEvent& event) {
+    Cell* cell;
+    size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &m_cells[pos & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t) sequence - (intptr_t) pos;
+        if (diff == 0) {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->event = event;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool TelemetryRing::pop(TelemetryEvent& event) {
+    Cell* cell;
+    size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &m_cells[pos & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t) sequence - (intptr_t) (pos + 1);
+        if (diff == 0) {
+            if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    event = cell->event;
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+size_t TelemetryRing::getCapacity() const {
+    return m_mask + 1;
+}
+
+size_t TelemetryRing::getNumDroppedEvents() const {
+    return m_dropped_events.load(std::memory_order_relaxed);
+}
+
+} // namespace anira
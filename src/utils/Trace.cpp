@@ -0,0 +1,265 @@
+#include <anira/utils/Trace.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace anira {
+
+namespace {
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    size_t capacity = 1 << 16;
+};
+
+TraceRegistry& getRegistry() {
+    static TraceRegistry registry;
+    return registry;
+}
+
+// Hands the buffer back to the registry when the thread exits
+struct ThreadTraceBuffer {
+    TraceBuffer* buffer = nullptr;
+
+    ~ThreadTraceBuffer() {
+        Tracer::unregisterThread();
+    }
+};
+
+thread_local ThreadTraceBuffer threadTraceBuffer;
+
+} // namespace
+
+const char* getTraceEventName(TraceEventType type) {
+    switch (type) {
+        case TraceEventType::PreProcessBegin:
+            return "preProcess";
+        case TraceEventType::Submit:
+            return "submit";
+        case TraceEventType::Dequeue:
+            return "dequeue";
+        case TraceEventType::InferenceBegin:
+            return "inference";
+        case TraceEventType::InferenceEnd:
+            return "inference end";
+        case TraceEventType::Done:
+            return "done";
+        case TraceEventType::PostProcessBegin:
+            return "postProcess";
+        case TraceEventType::Collect:
+            return "collect";
+    }
+    return "unknown";
+}
+
+TraceBuffer::TraceBuffer(size_t capacity, size_t index) :
+    m_events(std::make_unique<TraceEvent[]>(capacity)),
+    m_capacity(capacity),
+    m_index(index)
+{
+}
+
+void TraceBuffer::record(TraceEventType type, int sessionID, unsigned int slotID) {
+    if (m_clear_requested.load(std::memory_order_acquire)) {
+        m_size.store(0, std::memory_order_relaxed);
+        m_dropped_events.store(0, std::memory_order_relaxed);
+        m_clear_requested.store(false, std::memory_order_release);
+    }
+    size_t size = m_size.load(std::memory_order_relaxed);
+    if (size >= m_capacity) {
+        m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    int64_t time_stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    m_events[size] = {time_stamp, sessionID, slotID, type};
+    m_size.store(size + 1, std::memory_order_release);
+}
+
+size_t TraceBuffer::getNumEvents() const {
+    if (m_clear_requested.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    return m_size.load(std::memory_order_acquire);
+}
+
+const TraceEvent& TraceBuffer::getEvent(size_t index) const {
+    return m_events[index];
+}
+
+size_t TraceBuffer::getNumDroppedEvents() const {
+    if (m_clear_requested.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    return m_dropped_events.load(std::memory_order_relaxed);
+}
+
+size_t TraceBuffer::getIndex() const {
+    return m_index;
+}
+
+void TraceBuffer::requestClear() {
+    m_clear_requested.store(true, std::memory_order_release);
+}
+
+void Tracer::registerThread() {
+    if (threadTraceBuffer.buffer != nullptr) {
+        return;
+    }
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    // Reuse the buffer of a thread that has exited, so restarting the inference threads does not grow the registry
+    for (auto& buffer : registry.buffers) {
+        if (!buffer->m_in_use.load()) {
+            buffer->m_in_use.store(true);
+            threadTraceBuffer.buffer = buffer.get();
+            return;
+        }
+    }
+    registry.buffers.emplace_back(std::make_unique<TraceBuffer>(registry.capacity, registry.buffers.size()));
+    registry.buffers.back()->m_in_use.store(true);
+    threadTraceBuffer.buffer = registry.buffers.back().get();
+}
+
+void Tracer::unregisterThread() {
+    if (threadTraceBuffer.buffer == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(getRegistry().mutex);
+    threadTraceBuffer.buffer->m_in_use.store(false);
+    threadTraceBuffer.buffer = nullptr;
+}
+
+void Tracer::record(TraceEventType type, int sessionID, unsigned int slotID) {
+    if (threadTraceBuffer.buffer == nullptr) {
+        registerThread();
+    }
+    threadTraceBuffer.buffer->record(type, sessionID, slotID);
+}
+
+void Tracer::setBufferCapacity(size_t capacity) {
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.capacity = capacity > 0 ? capacity : 1;
+}
+
+size_t Tracer::getBufferCapacity() {
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.capacity;
+}
+
+void Tracer::clear() {
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& buffer : registry.buffers) {
+        buffer->requestClear();
+    }
+}
+
+size_t Tracer::getNumEvents() {
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    size_t num_events = 0;
+    for (auto& buffer : registry.buffers) {
+        num_events += buffer->getNumEvents();
+    }
+    return num_events;
+}
+
+size_t Tracer::getNumDroppedEvents() {
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    size_t num_dropped_events = 0;
+    for (auto& buffer : registry.buffers) {
+        num_dropped_events += buffer->getNumDroppedEvents();
+    }
+    return num_dropped_events;
+}
+
+void Tracer::writeChromeTrace(std::ostream& stream) {
+    TraceRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    // Snapshot the sizes once, so the events written are consistent with the start time
+    std::vector<size_t> num_events(registry.buffers.size());
+    int64_t start_time = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < registry.buffers.size(); ++i) {
+        num_events[i] = registry.buffers[i]->getNumEvents();
+        if (num_events[i] > 0 && registry.buffers[i]->getEvent(0).timeStamp < start_time) {
+            start_time = registry.buffers[i]->getEvent(0).timeStamp;
+        }
+    }
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto begin_event = [&] (const char* name, const char* phase, size_t tid, int64_t time_stamp) {
+        stream << (first ? "\n" : ",\n");
+        first = false;
+        stream << "{\"name\":\"" << name << "\",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid;
+        stream << ",\"ts\":" << std::fixed << std::setprecision(3) << (double) (time_stamp - start_time) * 1e-3;
+    };
+
+    for (size_t i = 0; i < registry.buffers.size(); ++i) {
+        const TraceBuffer& buffer = *registry.buffers[i];
+        if (num_events[i] == 0) {
+            continue;
+        }
+        stream << (first ? "\n" : ",\n");
+        first = false;
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.getIndex() << ",\"args\":{\"name\":\"anira thread " << buffer.getIndex() << "\"}}";
+
+        for (size_t j = 0; j < num_events[i]; ++j) {
+            const TraceEvent& event = buffer.getEvent(j);
+            // Flow events connect the stages of one slot across the threads
+            uint64_t flow_id = ((uint64_t) (unsigned int) event.sessionID << 32) | event.slotID;
+            const char* name = getTraceEventName(event.type);
+            switch (event.type) {
+                case TraceEventType::PreProcessBegin:
+                case TraceEventType::InferenceBegin:
+                case TraceEventType::PostProcessBegin:
+                    begin_event(name, "B", buffer.getIndex(), event.timeStamp);
+                    stream << ",\"args\":{\"session\":" << event.sessionID << ",\"slot\":" << event.slotID << "}}";
+                    break;
+                case TraceEventType::InferenceEnd:
+                case TraceEventType::Collect:
+                    begin_event(name, "E", buffer.getIndex(), event.timeStamp);
+                    stream << "}";
+                    break;
+                case TraceEventType::Submit:
+                    begin_event(name, "E", buffer.getIndex(), event.timeStamp);
+                    stream << "}";
+                    begin_event("slot", "s", buffer.getIndex(), event.timeStamp);
+                    stream << ",\"cat\":\"slot\",\"id\":" << flow_id << "}";
+                    break;
+                case TraceEventType::Dequeue:
+                case TraceEventType::Done:
+                    begin_event(name, "i", buffer.getIndex(), event.timeStamp);
+                    stream << ",\"s\":\"t\",\"args\":{\"session\":" << event.sessionID << ",\"slot\":" << event.slotID << "}}";
+                    begin_event("slot", "t", buffer.getIndex(), event.timeStamp);
+                    stream << ",\"cat\":\"slot\",\"id\":" << flow_id << "}";
+                    break;
+            }
+            if (event.type == TraceEventType::PostProcessBegin) {
+                begin_event("slot", "f", buffer.getIndex(), event.timeStamp);
+                stream << ",\"cat\":\"slot\",\"id\":" << flow_id << ",\"bp\":\"e\"}";
+            }
+        }
+    }
+    stream << "\n]}\n";
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    writeChromeTrace(file);
+    return file.good();
+}
+
+} // namespace anira
@@ -0,0 +1,90 @@
+#include <anira/utils/WaitableFlag.h>
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <ctime>
+#elif defined(_WIN32)
+    #include <windows.h>
+#endif
+
+namespace anira {
+
+void WaitableFlag::set() {
+    if (m_state.exchange(Set, std::memory_order_acq_rel) == Waiting) {
+        wakeConsumer();
+    }
+}
+
+bool WaitableFlag::tryConsume() {
+    uint32_t expected = Set;
+    return m_state.compare_exchange_strong(expected, Unset, std::memory_order_acq_rel);
+}
+
+bool WaitableFlag::consumeUntil(std::chrono::steady_clock::time_point deadline) {
+    if (tryConsume()) {
+        return true;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+        return false;
+    }
+    // Announce the waiter, fails if the producer has set the flag in the meantime
+    uint32_t expected = Unset;
+    if (!m_state.compare_exchange_strong(expected, Waiting, std::memory_order_acq_rel)) {
+        return tryConsume();
+    }
+    while (m_state.load(std::memory_order_acquire) == Waiting) {
+        if (!waitForState(deadline)) {
+            break;
+        }
+    }
+    // Withdraw the waiter, fails if the producer has set the flag
+    expected = Waiting;
+    if (m_state.compare_exchange_strong(expected, Unset, std::memory_order_acq_rel)) {
+        return false;
+    }
+    return tryConsume();
+}
+
+void WaitableFlag::consume() {
+    while (!consumeUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(100))) {
+    }
+}
+
+// Sleeps while the state is Waiting, returns false once the deadline has passed
+bool WaitableFlag::waitForState(std::chrono::steady_clock::time_point deadline) {
+    auto remaining = deadline - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero()) {
+        return false;
+    }
+#if defined(__linux__)
+    auto remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+    struct timespec timeout;
+    timeout.tv_sec = (time_t) (remaining_ns / 1000000000);
+    timeout.tv_nsec = (long) (remaining_ns % 1000000000);
+    // Returns immediately if the state is no longer Waiting, spurious wake-ups are handled by the caller
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_state), FUTEX_WAIT_PRIVATE, (uint32_t) Waiting, &timeout, nullptr, 0);
+#elif defined(_WIN32)
+    uint32_t waiting = Waiting;
+    // Rounded up so that the wait does not end just before the deadline and spin
+    DWORD remaining_ms = (DWORD) std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+    WaitOnAddress(reinterpret_cast<volatile void*>(&m_state), &waiting, sizeof(waiting), remaining_ms);
+#else
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(remaining, std::chrono::microseconds(50)));
+#endif
+    return true;
+}
+
+void WaitableFlag::wakeConsumer() {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+    WakeByAddressSingle(reinterpret_cast<void*>(&m_state));
+#endif
+}
+
+} // namespace anira
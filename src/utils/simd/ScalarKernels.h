@@ -0,0 +1,79 @@
+#ifndef ANIRA_SCALARKERNELS_H
+#define ANIRA_SCALARKERNELS_H
+
+// Scalar reference implementations, used as the fallback kernel table and for the tails of the vectorized kernels
+
+#include <anira/utils/SimdKernels.h>
+#include <cmath>
+#include <algorithm>
+
+namespace anira {
+namespace simd {
+namespace scalar {
+
+constexpr float INT16_TO_FLOAT = 1.f / 32768.f;
+constexpr float FLOAT_TO_INT16 = 32767.f;
+
+inline void copy(float* dst, const float* src, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        dst[i] = src[i];
+    }
+}
+
+inline void fill(float* dst, float value, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        dst[i] = value;
+    }
+}
+
+inline void copyWithGain(float* dst, const float* src, float gain, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        dst[i] = src[i] * gain;
+    }
+}
+
+inline void addWithGain(float* dst, const float* src, float gain, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+inline void interleave(float* dst, const float* const* src, size_t numChannels, size_t numSamples, size_t offset = 0) {
+    for (size_t i = offset; i < numSamples; ++i) {
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            dst[i * numChannels + channel] = src[channel][i];
+        }
+    }
+}
+
+inline void deinterleave(float* const* dst, const float* src, size_t numChannels, size_t numSamples, size_t offset = 0) {
+    for (size_t i = offset; i < numSamples; ++i) {
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            dst[channel][i] = src[i * numChannels + channel];
+        }
+    }
+}
+
+inline void int16ToFloat(float* dst, const int16_t* src, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        dst[i] = (float) src[i] * INT16_TO_FLOAT;
+    }
+}
+
+inline void floatToInt16(int16_t* dst, const float* src, size_t numSamples) {
+    for (size_t i = 0; i < numSamples; ++i) {
+        dst[i] = (int16_t) std::lrint(std::clamp(src[i], -1.f, 1.f) * FLOAT_TO_INT16);
+    }
+}
+
+} // namespace scalar
+
+const KernelTable* getKernelsSSE2();
+const KernelTable* getKernelsAVX2();
+const KernelTable* getKernelsAVX512();
+const KernelTable* getKernelsNEON();
+
+} // namespace simd
+} // namespace anira
+
+#endif //ANIRA_SCALARKERNELS_H
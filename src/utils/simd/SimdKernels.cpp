@@ -0,0 +1,142 @@
+#include "ScalarKernels.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+
+namespace anira {
+namespace simd {
+
+namespace {
+
+void interleaveScalar(float* dst, const float* const* src, size_t numChannels, size_t numSamples) {
+    scalar::interleave(dst, src, numChannels, numSamples);
+}
+
+void deinterleaveScalar(float* const* dst, const float* src, size_t numChannels, size_t numSamples) {
+    scalar::deinterleave(dst, src, numChannels, numSamples);
+}
+
+const KernelTable scalarKernels = {
+    InstructionSet::Scalar,
+    scalar::copy,
+    scalar::fill,
+    scalar::copyWithGain,
+    scalar::addWithGain,
+    interleaveScalar,
+    deinterleaveScalar,
+    scalar::int16ToFloat,
+    scalar::floatToInt16
+};
+
+bool cpuSupports(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return true;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        case InstructionSet::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case InstructionSet::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case InstructionSet::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        case InstructionSet::SSE2: {
+            int info[4];
+            __cpuid(info, 1);
+            return (info[3] & (1 << 26)) != 0;
+        }
+        case InstructionSet::AVX2:
+        case InstructionSet::AVX512: {
+            int info[4];
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave) return false;
+            unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            if (instructionSet == InstructionSet::AVX2) {
+                return (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+            }
+            return (xcr0 & 0xe6) == 0xe6 && (info[1] & (1 << 16)) != 0;
+        }
+#endif
+        case InstructionSet::NEON:
+            // When the NEON kernels are compiled in, the target architecture guarantees NEON
+            return true;
+        default:
+            return false;
+    }
+}
+
+const KernelTable* getCompiledKernels(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return &scalarKernels;
+#ifndef ANIRA_SIMD_SCALAR_ONLY
+        case InstructionSet::SSE2:
+            return getKernelsSSE2();
+        case InstructionSet::AVX2:
+            return getKernelsAVX2();
+        case InstructionSet::AVX512:
+            return getKernelsAVX512();
+        case InstructionSet::NEON:
+            return getKernelsNEON();
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+const KernelTable* selectKernels() {
+    const char* requested = std::getenv("ANIRA_SIMD");
+    if (requested != nullptr) {
+        for (InstructionSet instructionSet : {InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512, InstructionSet::NEON}) {
+            if (std::strcmp(requested, getInstructionSetName(instructionSet)) == 0) {
+                const KernelTable* kernels = getKernels(instructionSet);
+                if (kernels != nullptr) return kernels;
+            }
+        }
+    }
+    for (InstructionSet instructionSet : {InstructionSet::AVX512, InstructionSet::AVX2, InstructionSet::SSE2, InstructionSet::NEON}) {
+        const KernelTable* kernels = getKernels(instructionSet);
+        if (kernels != nullptr) return kernels;
+    }
+    return &scalarKernels;
+}
+
+} // namespace
+
+const KernelTable& getKernels() {
+    static const KernelTable* kernels = selectKernels();
+    return *kernels;
+}
+
+const KernelTable* getKernels(InstructionSet instructionSet) {
+    const KernelTable* kernels = getCompiledKernels(instructionSet);
+    if (kernels == nullptr || !cpuSupports(instructionSet)) {
+        return nullptr;
+    }
+    return kernels;
+}
+
+const char* getInstructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return "scalar";
+        case InstructionSet::SSE2:
+            return "sse2";
+        case InstructionSet::AVX2:
+            return "avx2";
+        case InstructionSet::AVX512:
+            return "avx512";
+        case InstructionSet::NEON:
+            return "neon";
+    }
+    return "unknown";
+}
+
+} // namespace simd
+} // namespace anira
@@ -0,0 +1,152 @@
+#include "ScalarKernels.h"
+
+#if defined(__AVX2__)
+#define ANIRA_HAS_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace anira {
+namespace simd {
+
+#ifdef ANIRA_HAS_AVX2_KERNELS
+
+namespace {
+
+void copyAVX2(float* dst, const float* src, size_t numSamples) {
+    size_t i = 0;
+    for (; i + 32 <= numSamples; i += 32) {
+        __m256 a = _mm256_loadu_ps(src + i);
+        __m256 b = _mm256_loadu_ps(src + i + 8);
+        __m256 c = _mm256_loadu_ps(src + i + 16);
+        __m256 d = _mm256_loadu_ps(src + i + 24);
+        _mm256_storeu_ps(dst + i, a);
+        _mm256_storeu_ps(dst + i + 8, b);
+        _mm256_storeu_ps(dst + i + 16, c);
+        _mm256_storeu_ps(dst + i + 24, d);
+    }
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_loadu_ps(src + i));
+    }
+    scalar::copy(dst + i, src + i, numSamples - i);
+}
+
+void fillAVX2(float* dst, float value, size_t numSamples) {
+    __m256 v = _mm256_set1_ps(value);
+    size_t i = 0;
+    for (; i + 32 <= numSamples; i += 32) {
+        _mm256_storeu_ps(dst + i, v);
+        _mm256_storeu_ps(dst + i + 8, v);
+        _mm256_storeu_ps(dst + i + 16, v);
+        _mm256_storeu_ps(dst + i + 24, v);
+    }
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(dst + i, v);
+    }
+    scalar::fill(dst + i, value, numSamples - i);
+}
+
+void copyWithGainAVX2(float* dst, const float* src, float gain, size_t numSamples) {
+    __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+    }
+    scalar::copyWithGain(dst + i, src + i, gain, numSamples - i);
+}
+
+void addWithGainAVX2(float* dst, const float* src, float gain, size_t numSamples) {
+    __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        // No fused multiply add, so that the results are bit identical to the other kernels
+        __m256 sum = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+        _mm256_storeu_ps(dst + i, sum);
+    }
+    scalar::addWithGain(dst + i, src + i, gain, numSamples - i);
+}
+
+void interleaveAVX2(float* dst, const float* const* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        for (; i + 8 <= numSamples; i += 8) {
+            __m256 left = _mm256_loadu_ps(src[0] + i);
+            __m256 right = _mm256_loadu_ps(src[1] + i);
+            __m256 lo = _mm256_unpacklo_ps(left, right);
+            __m256 hi = _mm256_unpackhi_ps(left, right);
+            _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+            _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+        }
+    }
+    scalar::interleave(dst, src, numChannels, numSamples, i);
+}
+
+void deinterleaveAVX2(float* const* dst, const float* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        for (; i + 8 <= numSamples; i += 8) {
+            __m256 a = _mm256_loadu_ps(src + 2 * i);
+            __m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+            __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+            __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+            _mm256_storeu_ps(dst[0] + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm256_storeu_ps(dst[1] + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+    scalar::deinterleave(dst, src, numChannels, numSamples, i);
+}
+
+void int16ToFloatAVX2(float* dst, const int16_t* src, size_t numSamples) {
+    __m256 scale = _mm256_set1_ps(scalar::INT16_TO_FLOAT);
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    scalar::int16ToFloat(dst + i, src + i, numSamples - i);
+}
+
+void floatToInt16AVX2(int16_t* dst, const float* src, size_t numSamples) {
+    __m256 scale = _mm256_set1_ps(scalar::FLOAT_TO_INT16);
+    __m256 upper = _mm256_set1_ps(1.f);
+    __m256 lower = _mm256_set1_ps(-1.f);
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m256 a = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(src + i), upper), lower);
+        __m256 b = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(src + i + 8), upper), lower);
+        __m256i lo = _mm256_cvtps_epi32(_mm256_mul_ps(a, scale));
+        __m256i hi = _mm256_cvtps_epi32(_mm256_mul_ps(b, scale));
+        // The pack works per 128 bit lane, the permutation restores the sample order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    scalar::floatToInt16(dst + i, src + i, numSamples - i);
+}
+
+const KernelTable kernelsAVX2 = {
+    InstructionSet::AVX2,
+    copyAVX2,
+    fillAVX2,
+    copyWithGainAVX2,
+    addWithGainAVX2,
+    interleaveAVX2,
+    deinterleaveAVX2,
+    int16ToFloatAVX2,
+    floatToInt16AVX2
+};
+
+} // namespace
+
+const KernelTable* getKernelsAVX2() {
+    return &kernelsAVX2;
+}
+
+#else
+
+const KernelTable* getKernelsAVX2() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace simd
+} // namespace anira
@@ -0,0 +1,166 @@
+#include "ScalarKernels.h"
+
+#if defined(__AVX512F__)
+#define ANIRA_HAS_AVX512_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace anira {
+namespace simd {
+
+#ifdef ANIRA_HAS_AVX512_KERNELS
+
+namespace {
+
+// Mask that selects the first numSamples (< 16) lanes
+inline __mmask16 tailMask(size_t numSamples) {
+    return (__mmask16) ((1u << numSamples) - 1u);
+}
+
+void copyAVX512(float* dst, const float* src, size_t numSamples) {
+    size_t i = 0;
+    for (; i + 64 <= numSamples; i += 64) {
+        __m512 a = _mm512_loadu_ps(src + i);
+        __m512 b = _mm512_loadu_ps(src + i + 16);
+        __m512 c = _mm512_loadu_ps(src + i + 32);
+        __m512 d = _mm512_loadu_ps(src + i + 48);
+        _mm512_storeu_ps(dst + i, a);
+        _mm512_storeu_ps(dst + i + 16, b);
+        _mm512_storeu_ps(dst + i + 32, c);
+        _mm512_storeu_ps(dst + i + 48, d);
+    }
+    for (; i + 16 <= numSamples; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_loadu_ps(src + i));
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        _mm512_mask_storeu_ps(dst + i, mask, _mm512_maskz_loadu_ps(mask, src + i));
+    }
+}
+
+void fillAVX512(float* dst, float value, size_t numSamples) {
+    __m512 v = _mm512_set1_ps(value);
+    size_t i = 0;
+    for (; i + 64 <= numSamples; i += 64) {
+        _mm512_storeu_ps(dst + i, v);
+        _mm512_storeu_ps(dst + i + 16, v);
+        _mm512_storeu_ps(dst + i + 32, v);
+        _mm512_storeu_ps(dst + i + 48, v);
+    }
+    for (; i + 16 <= numSamples; i += 16) {
+        _mm512_storeu_ps(dst + i, v);
+    }
+    if (i < numSamples) {
+        _mm512_mask_storeu_ps(dst + i, tailMask(numSamples - i), v);
+    }
+}
+
+void copyWithGainAVX512(float* dst, const float* src, float gain, size_t numSamples) {
+    __m512 g = _mm512_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_loadu_ps(src + i), g));
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        _mm512_mask_storeu_ps(dst + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, src + i), g));
+    }
+}
+
+void addWithGainAVX512(float* dst, const float* src, float gain, size_t numSamples) {
+    __m512 g = _mm512_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        // No fused multiply add, so that the results are bit identical to the other kernels
+        __m512 sum = _mm512_add_ps(_mm512_loadu_ps(dst + i), _mm512_mul_ps(_mm512_loadu_ps(src + i), g));
+        _mm512_storeu_ps(dst + i, sum);
+    }
+    if (i < numSamples) {
+        __mmask16 mask = tailMask(numSamples - i);
+        __m512 sum = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dst + i), _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, src + i), g));
+        _mm512_mask_storeu_ps(dst + i, mask, sum);
+    }
+}
+
+void interleaveAVX512(float* dst, const float* const* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        const __m512i lo_index = _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0);
+        const __m512i hi_index = _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8);
+        for (; i + 16 <= numSamples; i += 16) {
+            __m512 left = _mm512_loadu_ps(src[0] + i);
+            __m512 right = _mm512_loadu_ps(src[1] + i);
+            _mm512_storeu_ps(dst + 2 * i, _mm512_permutex2var_ps(left, lo_index, right));
+            _mm512_storeu_ps(dst + 2 * i + 16, _mm512_permutex2var_ps(left, hi_index, right));
+        }
+    }
+    scalar::interleave(dst, src, numChannels, numSamples, i);
+}
+
+void deinterleaveAVX512(float* const* dst, const float* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        const __m512i even_index = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+        const __m512i odd_index = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+        for (; i + 16 <= numSamples; i += 16) {
+            __m512 a = _mm512_loadu_ps(src + 2 * i);
+            __m512 b = _mm512_loadu_ps(src + 2 * i + 16);
+            _mm512_storeu_ps(dst[0] + i, _mm512_permutex2var_ps(a, even_index, b));
+            _mm512_storeu_ps(dst[1] + i, _mm512_permutex2var_ps(a, odd_index, b));
+        }
+    }
+    scalar::deinterleave(dst, src, numChannels, numSamples, i);
+}
+
+void int16ToFloatAVX512(float* dst, const int16_t* src, size_t numSamples) {
+    __m512 scale = _mm512_set1_ps(scalar::INT16_TO_FLOAT);
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m512i v = _mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_cvtepi32_ps(v), scale));
+    }
+    // Masked 16 bit loads would need AVX-512BW, the tail is short enough for the scalar loop
+    scalar::int16ToFloat(dst + i, src + i, numSamples - i);
+}
+
+void floatToInt16AVX512(int16_t* dst, const float* src, size_t numSamples) {
+    __m512 scale = _mm512_set1_ps(scalar::FLOAT_TO_INT16);
+    __m512 upper = _mm512_set1_ps(1.f);
+    __m512 lower = _mm512_set1_ps(-1.f);
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m512 v = _mm512_max_ps(_mm512_min_ps(_mm512_loadu_ps(src + i), upper), lower);
+        __m256i packed = _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(_mm512_mul_ps(v, scale)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    scalar::floatToInt16(dst + i, src + i, numSamples - i);
+}
+
+const KernelTable kernelsAVX512 = {
+    InstructionSet::AVX512,
+    copyAVX512,
+    fillAVX512,
+    copyWithGainAVX512,
+    addWithGainAVX512,
+    interleaveAVX512,
+    deinterleaveAVX512,
+    int16ToFloatAVX512,
+    floatToInt16AVX512
+};
+
+} // namespace
+
+const KernelTable* getKernelsAVX512() {
+    return &kernelsAVX512;
+}
+
+#else
+
+const KernelTable* getKernelsAVX512() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace simd
+} // namespace anira
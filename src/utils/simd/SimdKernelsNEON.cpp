@@ -0,0 +1,147 @@
+#include "ScalarKernels.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ANIRA_HAS_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+
+namespace anira {
+namespace simd {
+
+#ifdef ANIRA_HAS_NEON_KERNELS
+
+namespace {
+
+void copyNEON(float* dst, const float* src, size_t numSamples) {
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        float32x4_t a = vld1q_f32(src + i);
+        float32x4_t b = vld1q_f32(src + i + 4);
+        float32x4_t c = vld1q_f32(src + i + 8);
+        float32x4_t d = vld1q_f32(src + i + 12);
+        vst1q_f32(dst + i, a);
+        vst1q_f32(dst + i + 4, b);
+        vst1q_f32(dst + i + 8, c);
+        vst1q_f32(dst + i + 12, d);
+    }
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(dst + i, vld1q_f32(src + i));
+    }
+    scalar::copy(dst + i, src + i, numSamples - i);
+}
+
+void fillNEON(float* dst, float value, size_t numSamples) {
+    float32x4_t v = vdupq_n_f32(value);
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        vst1q_f32(dst + i, v);
+        vst1q_f32(dst + i + 4, v);
+        vst1q_f32(dst + i + 8, v);
+        vst1q_f32(dst + i + 12, v);
+    }
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(dst + i, v);
+    }
+    scalar::fill(dst + i, value, numSamples - i);
+}
+
+void copyWithGainNEON(float* dst, const float* src, float gain, size_t numSamples) {
+    size_t i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), gain));
+    }
+    scalar::copyWithGain(dst + i, src + i, gain, numSamples - i);
+}
+
+void addWithGainNEON(float* dst, const float* src, float gain, size_t numSamples) {
+    size_t i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        // No fused multiply add, so that the results are bit identical to the other kernels
+        float32x4_t sum = vaddq_f32(vld1q_f32(dst + i), vmulq_n_f32(vld1q_f32(src + i), gain));
+        vst1q_f32(dst + i, sum);
+    }
+    scalar::addWithGain(dst + i, src + i, gain, numSamples - i);
+}
+
+void interleaveNEON(float* dst, const float* const* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        for (; i + 4 <= numSamples; i += 4) {
+            float32x4x2_t v;
+            v.val[0] = vld1q_f32(src[0] + i);
+            v.val[1] = vld1q_f32(src[1] + i);
+            vst2q_f32(dst + 2 * i, v);
+        }
+    }
+    scalar::interleave(dst, src, numChannels, numSamples, i);
+}
+
+void deinterleaveNEON(float* const* dst, const float* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        for (; i + 4 <= numSamples; i += 4) {
+            float32x4x2_t v = vld2q_f32(src + 2 * i);
+            vst1q_f32(dst[0] + i, v.val[0]);
+            vst1q_f32(dst[1] + i, v.val[1]);
+        }
+    }
+    scalar::deinterleave(dst, src, numChannels, numSamples, i);
+}
+
+void int16ToFloatNEON(float* dst, const int16_t* src, size_t numSamples) {
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        int16x8_t v = vld1q_s16(src + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+        vst1q_f32(dst + i, vmulq_n_f32(lo, scalar::INT16_TO_FLOAT));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(hi, scalar::INT16_TO_FLOAT));
+    }
+    scalar::int16ToFloat(dst + i, src + i, numSamples - i);
+}
+
+void floatToInt16NEON(int16_t* dst, const float* src, size_t numSamples) {
+    size_t i = 0;
+#if defined(__aarch64__) || defined(_M_ARM64)
+    float32x4_t upper = vdupq_n_f32(1.f);
+    float32x4_t lower = vdupq_n_f32(-1.f);
+    for (; i + 8 <= numSamples; i += 8) {
+        float32x4_t a = vmaxq_f32(vminq_f32(vld1q_f32(src + i), upper), lower);
+        float32x4_t b = vmaxq_f32(vminq_f32(vld1q_f32(src + i + 4), upper), lower);
+        // Round to nearest is only available on AArch64, 32 bit ARM uses the scalar loop
+        int32x4_t lo = vcvtnq_s32_f32(vmulq_n_f32(a, scalar::FLOAT_TO_INT16));
+        int32x4_t hi = vcvtnq_s32_f32(vmulq_n_f32(b, scalar::FLOAT_TO_INT16));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+#endif
+    scalar::floatToInt16(dst + i, src + i, numSamples - i);
+}
+
+const KernelTable kernelsNEON = {
+    InstructionSet::NEON,
+    copyNEON,
+    fillNEON,
+    copyWithGainNEON,
+    addWithGainNEON,
+    interleaveNEON,
+    deinterleaveNEON,
+    int16ToFloatNEON,
+    floatToInt16NEON
+};
+
+} // namespace
+
+const KernelTable* getKernelsNEON() {
+    return &kernelsNEON;
+}
+
+#else
+
+const KernelTable* getKernelsNEON() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace simd
+} // namespace anira
@@ -0,0 +1,149 @@
+#include "ScalarKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIRA_HAS_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace anira {
+namespace simd {
+
+#ifdef ANIRA_HAS_SSE2_KERNELS
+
+namespace {
+
+void copySSE2(float* dst, const float* src, size_t numSamples) {
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m128 a = _mm_loadu_ps(src + i);
+        __m128 b = _mm_loadu_ps(src + i + 4);
+        __m128 c = _mm_loadu_ps(src + i + 8);
+        __m128 d = _mm_loadu_ps(src + i + 12);
+        _mm_storeu_ps(dst + i, a);
+        _mm_storeu_ps(dst + i + 4, b);
+        _mm_storeu_ps(dst + i + 8, c);
+        _mm_storeu_ps(dst + i + 12, d);
+    }
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_loadu_ps(src + i));
+    }
+    scalar::copy(dst + i, src + i, numSamples - i);
+}
+
+void fillSSE2(float* dst, float value, size_t numSamples) {
+    __m128 v = _mm_set1_ps(value);
+    size_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        _mm_storeu_ps(dst + i, v);
+        _mm_storeu_ps(dst + i + 4, v);
+        _mm_storeu_ps(dst + i + 8, v);
+        _mm_storeu_ps(dst + i + 12, v);
+    }
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(dst + i, v);
+    }
+    scalar::fill(dst + i, value, numSamples - i);
+}
+
+void copyWithGainSSE2(float* dst, const float* src, float gain, size_t numSamples) {
+    __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+    }
+    scalar::copyWithGain(dst + i, src + i, gain, numSamples - i);
+}
+
+void addWithGainSSE2(float* dst, const float* src, float gain, size_t numSamples) {
+    __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g));
+        _mm_storeu_ps(dst + i, sum);
+    }
+    scalar::addWithGain(dst + i, src + i, gain, numSamples - i);
+}
+
+void interleaveSSE2(float* dst, const float* const* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        for (; i + 4 <= numSamples; i += 4) {
+            __m128 left = _mm_loadu_ps(src[0] + i);
+            __m128 right = _mm_loadu_ps(src[1] + i);
+            _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(left, right));
+            _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(left, right));
+        }
+    }
+    scalar::interleave(dst, src, numChannels, numSamples, i);
+}
+
+void deinterleaveSSE2(float* const* dst, const float* src, size_t numChannels, size_t numSamples) {
+    size_t i = 0;
+    if (numChannels == 2) {
+        for (; i + 4 <= numSamples; i += 4) {
+            __m128 a = _mm_loadu_ps(src + 2 * i);
+            __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+            _mm_storeu_ps(dst[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(dst[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+    scalar::deinterleave(dst, src, numChannels, numSamples, i);
+}
+
+void int16ToFloatSSE2(float* dst, const int16_t* src, size_t numSamples) {
+    __m128 scale = _mm_set1_ps(scalar::INT16_TO_FLOAT);
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // Sign extend by moving the 16 bit values into the upper half and shifting them back arithmetically
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    scalar::int16ToFloat(dst + i, src + i, numSamples - i);
+}
+
+void floatToInt16SSE2(int16_t* dst, const float* src, size_t numSamples) {
+    __m128 scale = _mm_set1_ps(scalar::FLOAT_TO_INT16);
+    __m128 upper = _mm_set1_ps(1.f);
+    __m128 lower = _mm_set1_ps(-1.f);
+    size_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128 a = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i), upper), lower);
+        __m128 b = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i + 4), upper), lower);
+        __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+        __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+    scalar::floatToInt16(dst + i, src + i, numSamples - i);
+}
+
+const KernelTable kernelsSSE2 = {
+    InstructionSet::SSE2,
+    copySSE2,
+    fillSSE2,
+    copyWithGainSSE2,
+    addWithGainSSE2,
+    interleaveSSE2,
+    deinterleaveSSE2,
+    int16ToFloatSSE2,
+    floatToInt16SSE2
+};
+
+} // namespace
+
+const KernelTable* getKernelsSSE2() {
+    return &kernelsSSE2;
+}
+
+#else
+
+const KernelTable* getKernelsSSE2() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace simd
+} // namespace anira